@@ -5,11 +5,10 @@ local extendedJSONData = {}
 local maxPacketSize = 65000
 
 function ProtocolGame:onOpcode(opcode, msg)
-    for i, callback in pairs(opcodeCallbacks) do
-        if i == opcode then
-            callback(self, msg)
-            return true
-        end
+    local callback = opcodeCallbacks[opcode]
+    if callback then
+        callback(self, msg)
+        return true
     end
     return false
 end
@@ -52,10 +51,12 @@ function ProtocolGame.registerOpcode(opcode, callback)
     end
 
     opcodeCallbacks[opcode] = callback
+    ProtocolGame.setOpcodeIntercepted(opcode, true)
 end
 
 function ProtocolGame.unregisterOpcode(opcode)
     opcodeCallbacks[opcode] = nil
+    ProtocolGame.setOpcodeIntercepted(opcode, false)
 end
 
 function ProtocolGame.registerExtendedOpcode(opcode, callback)
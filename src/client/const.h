@@ -46,6 +46,7 @@ namespace Otc
         DrawBars = 1 << 2,
         DrawNames = 1 << 3,
         DrawManaBar = 1 << 4,
+        DrawRetained = 1 << 5, // reuse the recorded draws of static things, see Tile::drawRetained
         DrawThingsAndLights = DrawThings | DrawLights,
         DrawCreatureInfo = DrawBars | DrawNames | DrawManaBar,
     };
@@ -284,8 +284,13 @@ void Creature::internalDraw(Point dest, LightView* lightView, const Color& color
             const auto& datType = getThingType();
             const int animationPhase = getCurrentAnimationPhase();
             const bool useFramebuffer = !replaceColorShader && m_shader && m_shader->useFramebuffer();
+            const bool useOutfitCache = m_drawOutfitColor && !replaceColorShader && !m_shader && getLayers() > 1 && g_things.isOutfitCacheEnabled();
 
             const auto& drawCreature = [&](const Point& dest) {
+                // colors and addons already baked into a single frame
+                if (useOutfitCache && g_things.getOutfitCache().draw(dest, datType, m_outfit, m_numPatternX, m_numPatternZ, animationPhase, color))
+                    return;
+
                 // yPattern => creature addon
                 for (int yPattern = 0; yPattern < getNumPatternY(); ++yPattern) {
                     // continue if we dont have this addon
@@ -116,6 +116,8 @@ void Game::processDisconnect()
         m_protocolGame->disconnect();
         m_protocolGame = nullptr;
     }
+
+    ProtocolGame::resetPacketsPerSecond();
 }
 
 void Game::processUpdateNeeded(const std::string_view signature)
@@ -38,7 +38,7 @@
 
 ItemPtr Item::create(int id)
 {
-    const auto& item = std::make_shared<Item>();
+    const auto& item = stdext::make_pooled<Item>();
     item->setId(id);
 
     return item;
@@ -79,6 +79,26 @@ void Item::internalDraw(int animationPhase, const Point& dest, const Color& colo
     }
 }
 
+uint64_t Item::getRetainedDrawKey()
+{
+    if (m_shader || isMarked() || isHighlighted() || m_color != Color::white || !canDraw() || isHided() || hasLight()
+        || !m_attachedEffects.empty() || !m_attachedParticles.empty())
+        return 0;
+
+    const int animationPhase = calculateAnimationPhase();
+
+    // not loaded yet or collected, the usual draw will load it
+    if (!m_thingType->hasTexture(animationPhase))
+        return 0;
+
+    m_thingType->markTextureUsed();
+
+    // the generation tells a region of the atlas reused by another texture since it was recorded
+    const uint32_t patterns = static_cast<uint32_t>(m_numPatternX) << 24 | m_numPatternY << 16 | m_numPatternZ << 8 | animationPhase;
+    const uint64_t generation = m_thingType->getTextureGeneration() & 0x7fff;
+    return uint64_t{ 1 } << 63 | generation << 48 | static_cast<uint64_t>(m_clientId) << 32 | patterns;
+}
+
 void Item::setConductor()
 {
     if (isSingleGround()) {
@@ -108,7 +128,7 @@ int Item::getSubType()
 
 ItemPtr Item::clone()
 {
-    auto item = std::make_shared<Item>();
+    auto item = stdext::make_pooled<Item>();
     *(item.get()) = *this;
     return item;
 }
@@ -280,7 +300,7 @@ std::string Item::getName()
 
 ItemPtr Item::createFromOtb(int id)
 {
-    const auto& item = std::make_shared<Item>();
+    const auto& item = stdext::make_pooled<Item>();
     item->setOtbId(id);
 
     return item;
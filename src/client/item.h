@@ -101,6 +101,10 @@ public:
 
     void updatePatterns();
     int calculateAnimationPhase();
+
+    // identifies what draw() adds while the item is a plain sprite, so its draws can be
+    // retained; 0 when it needs the usual draw (shader, marks, light, attached effects...)
+    uint64_t getRetainedDrawKey();
     int getExactSize(int layer = 0, int xPattern = 0, int yPattern = 0, int zPattern = 0, int animationPhase = 0) override {
         return Thing::getExactSize(layer, m_numPatternX, m_numPatternY, m_numPatternZ, calculateAnimationPhase());
     }
@@ -51,6 +51,7 @@ void LightView::resize(const Size& size, const uint16_t tileSize) {
     }
 
     m_pixels.resize(size.area() * 4);
+    m_intensities.resize(size.width());
 
     if (m_texture)
         m_texture->setupSize(m_mapSize);
@@ -144,34 +145,63 @@ void LightView::updatePixels() {
 
     const auto& lightData = m_lightData[1];
 
-    const size_t lightSize = lightData.lights.size();
-
     const int mapWidth = m_mapSize.width();
     const int mapHeight = m_mapSize.height();
 
-    for (int x = -1; ++x < mapWidth;) {
-        for (int y = -1; ++y < mapHeight;) {
-            const Point pos(x * m_tileSize + m_tileSize / 2, y * m_tileSize + m_tileSize / 2);
-            const int index = (y * mapWidth + x);
-            const int colorIndex = index * 4;
-            m_pixels[colorIndex] = m_globalLightColor.r();
-            m_pixels[colorIndex + 1] = m_globalLightColor.g();
-            m_pixels[colorIndex + 2] = m_globalLightColor.b();
-            m_pixels[colorIndex + 3] = 255; // alpha channel
-            for (size_t i = lightData.tiles[index]; i < lightSize; ++i) {
-                const auto& light = lightData.lights[i];
-                const float distance = (std::sqrt((pos.x - light.pos.x) * (pos.x - light.pos.x) +
-                                        (pos.y - light.pos.y) * (pos.y - light.pos.y))) / m_tileSize;
-
-                float intensity = (-distance + light.intensity) * 0.2f;
-                if (intensity < 0.01f) continue;
-                if (intensity > 1.0f) intensity = 1.0f;
-
-                const auto& lightColor = Color::from8bit(light.color) * intensity;
-                m_pixels[colorIndex] = std::max<int>(m_pixels[colorIndex], lightColor.r());
-                m_pixels[colorIndex + 1] = std::max<int>(m_pixels[colorIndex + 1], lightColor.g());
-                m_pixels[colorIndex + 2] = std::max<int>(m_pixels[colorIndex + 2], lightColor.b());
+    for (size_t i = 0, size = m_pixels.size(); i < size; i += 4) {
+        m_pixels[i] = m_globalLightColor.r();
+        m_pixels[i + 1] = m_globalLightColor.g();
+        m_pixels[i + 2] = m_globalLightColor.b();
+        m_pixels[i + 3] = 255; // alpha channel
+    }
+
+    const int halfTileSize = m_tileSize / 2;
+    const float invTileSize = 1.f / m_tileSize;
+
+    // Instead of testing every tile against every light, each light only visits
+    // the tiles inside its radius, a light never reaches tiles further than its intensity.
+    for (size_t i = 0, lightSize = lightData.lights.size(); i < lightSize; ++i) {
+        const auto& light = lightData.lights[i];
+
+        const auto& color = Color::from8bit(light.color);
+        if (color == Color::alpha)
+            continue;
+
+        const int radius = light.intensity + 1;
+        const int tileX = light.pos.x / m_tileSize;
+        const int tileY = light.pos.y / m_tileSize;
+
+        const int fromX = std::max<int>(tileX - radius, 0);
+        const int toX = std::min<int>(tileX + radius, mapWidth - 1);
+        const int fromY = std::max<int>(tileY - radius, 0);
+        const int toY = std::min<int>(tileY + radius, mapHeight - 1);
+        if (fromX > toX || fromY > toY)
+            continue;
+
+        const float lightIntensity = light.intensity;
+        for (int y = fromY; y <= toY; ++y) {
+            const int dy = y * m_tileSize + halfTileSize - light.pos.y;
+            const int dy2 = dy * dy;
+
+            // branchless pass, so that the compiler can vectorize the distance/falloff
+            float* intensity = m_intensities.data();
+            for (int x = fromX; x <= toX; ++x) {
+                const int dx = x * m_tileSize + halfTileSize - light.pos.x;
+                const float distance = std::sqrt(static_cast<float>(dx * dx + dy2)) * invTileSize;
+                *intensity++ = std::min<float>((lightIntensity - distance) * 0.2f, 1.f);
+            }
+
+            intensity = m_intensities.data();
+            for (int x = fromX; x <= toX; ++x, ++intensity) {
+                const int index = y * mapWidth + x;
+                if (*intensity < 0.01f || lightData.tiles[index] > i)
+                    continue;
+
+                const int colorIndex = index * 4;
+                m_pixels[colorIndex] = std::max<uint8_t>(m_pixels[colorIndex], static_cast<uint8_t>(color.rF() * *intensity * 255.f));
+                m_pixels[colorIndex + 1] = std::max<uint8_t>(m_pixels[colorIndex + 1], static_cast<uint8_t>(color.gF() * *intensity * 255.f));
+                m_pixels[colorIndex + 2] = std::max<uint8_t>(m_pixels[colorIndex + 2], static_cast<uint8_t>(color.bF() * *intensity * 255.f));
             }
         }
     }
-}
\ No newline at end of file
+}
@@ -83,4 +83,5 @@ private:
     TexturePtr m_texture;
     LightData m_lightData[2];
     std::vector<uint8_t> m_pixels;
+    std::vector<float> m_intensities;
 };
@@ -67,6 +67,14 @@ void Client::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_things", "loadDat", &ThingTypeManager::loadDat, &g_things);
     g_lua.bindSingletonFunction("g_things", "loadOtml", &ThingTypeManager::loadOtml, &g_things);
     g_lua.bindSingletonFunction("g_things", "isDatLoaded", &ThingTypeManager::isDatLoaded, &g_things);
+    g_lua.bindSingletonFunction("g_things", "setTextureAtlasEnabled", &ThingTypeManager::setTextureAtlasEnabled, &g_things);
+    g_lua.bindSingletonFunction("g_things", "isTextureAtlasEnabled", &ThingTypeManager::isTextureAtlasEnabled, &g_things);
+    g_lua.bindSingletonFunction("g_things", "getTextureAtlasPages", &ThingTypeManager::getTextureAtlasPages, &g_things);
+    g_lua.bindSingletonFunction("g_things", "getTextureAtlasRegions", &ThingTypeManager::getTextureAtlasRegions, &g_things);
+    g_lua.bindSingletonFunction("g_things", "setOutfitCacheEnabled", &ThingTypeManager::setOutfitCacheEnabled, &g_things);
+    g_lua.bindSingletonFunction("g_things", "isOutfitCacheEnabled", &ThingTypeManager::isOutfitCacheEnabled, &g_things);
+    g_lua.bindSingletonFunction("g_things", "getOutfitCacheHits", &ThingTypeManager::getOutfitCacheHits, &g_things);
+    g_lua.bindSingletonFunction("g_things", "getOutfitCacheMisses", &ThingTypeManager::getOutfitCacheMisses, &g_things);
     g_lua.bindSingletonFunction("g_things", "getDatSignature", &ThingTypeManager::getDatSignature, &g_things);
     g_lua.bindSingletonFunction("g_things", "getContentRevision", &ThingTypeManager::getContentRevision, &g_things);
     g_lua.bindSingletonFunction("g_things", "getThingType", &ThingTypeManager::getThingType, &g_things);
@@ -121,6 +129,12 @@ void Client::registerLuaFunctions()
     g_lua.registerSingletonClass("g_spriteAppearances");
     g_lua.bindSingletonFunction("g_spriteAppearances", "saveSpriteToFile", &SpriteAppearances::saveSpriteToFile, &g_spriteAppearances);
     g_lua.bindSingletonFunction("g_spriteAppearances", "saveSheetToFileBySprite", &SpriteAppearances::saveSheetToFileBySprite, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "setSheetCacheLimit", &SpriteAppearances::setSheetCacheLimit, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "getSheetCacheLimit", &SpriteAppearances::getSheetCacheLimit, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "getSheetCacheSize", &SpriteAppearances::getSheetCacheSize, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "getSheetCacheHits", &SpriteAppearances::getSheetCacheHits, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "getSheetCacheMisses", &SpriteAppearances::getSheetCacheMisses, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "getSheetCacheEvictions", &SpriteAppearances::getSheetCacheEvictions, &g_spriteAppearances);
 
     g_lua.registerSingletonClass("g_map");
     g_lua.bindSingletonFunction("g_map", "isLookPossible", &Map::isLookPossible, &g_map);
@@ -391,6 +405,13 @@ void Client::registerLuaFunctions()
     g_lua.registerClass<ProtocolGame, Protocol>();
     g_lua.bindClassStaticFunction<ProtocolGame>("create", [] { return std::make_shared<ProtocolGame>(); });
     g_lua.bindClassMemberFunction<ProtocolGame>("sendExtendedOpcode", &ProtocolGame::sendExtendedOpcode);
+    g_lua.bindClassStaticFunction<ProtocolGame>("setOpcodeIntercepted", &ProtocolGame::setOpcodeIntercepted);
+    g_lua.bindClassStaticFunction<ProtocolGame>("isOpcodeIntercepted", &ProtocolGame::isOpcodeIntercepted);
+    g_lua.bindClassStaticFunction<ProtocolGame>("setOpcodeProfiling", &ProtocolGame::setOpcodeProfiling);
+    g_lua.bindClassStaticFunction<ProtocolGame>("isOpcodeProfiling", &ProtocolGame::isOpcodeProfiling);
+    g_lua.bindClassStaticFunction<ProtocolGame>("resetOpcodeProfile", &ProtocolGame::resetOpcodeProfile);
+    g_lua.bindClassStaticFunction<ProtocolGame>("getOpcodeProfile", &ProtocolGame::getOpcodeProfile);
+    g_lua.bindClassStaticFunction<ProtocolGame>("getPacketsPerSecond", &ProtocolGame::getPacketsPerSecond);
 
     g_lua.registerClass<Container>();
     g_lua.bindClassMemberFunction<Container>("getItem", &Container::getItem);
@@ -719,11 +740,11 @@ void Client::registerLuaFunctions()
 #endif
 
     g_lua.registerClass<Effect, Thing>();
-    g_lua.bindClassStaticFunction<Effect>("create", [] { return std::make_shared<Effect>(); });
+    g_lua.bindClassStaticFunction<Effect>("create", [] { return stdext::make_pooled<Effect>(); });
     g_lua.bindClassMemberFunction<Effect>("setId", &Effect::setId);
 
     g_lua.registerClass<Missile, Thing>();
-    g_lua.bindClassStaticFunction<Missile>("create", [] { return std::make_shared<Missile>(); });
+    g_lua.bindClassStaticFunction<Missile>("create", [] { return stdext::make_pooled<Missile>(); });
     g_lua.bindClassMemberFunction<Missile>("setId", &Missile::setId);
     g_lua.bindClassMemberFunction<Missile>("setPath", &Missile::setPath);
 
@@ -962,6 +983,12 @@ void Client::registerLuaFunctions()
     g_lua.bindClassMemberFunction<UIMap>("getMinimumAmbientLight", &UIMap::getMinimumAmbientLight);
     g_lua.bindClassMemberFunction<UIMap>("getSpectators", &UIMap::getSpectators);
     g_lua.bindClassMemberFunction<UIMap>("getSightSpectators", &UIMap::getSightSpectators);
+    g_lua.bindClassMemberFunction<UIMap>("getVisibleTilesStats", &UIMap::getVisibleTilesStats);
+    g_lua.bindClassMemberFunction<UIMap>("getRetainedDrawStats", &UIMap::getRetainedDrawStats);
+    g_lua.bindClassMemberFunction<UIMap>("setRetainedDraw", &UIMap::setRetainedDraw);
+    g_lua.bindClassMemberFunction<UIMap>("isRetainedDraw", &UIMap::isRetainedDraw);
+    g_lua.bindClassMemberFunction<UIMap>("setRetainedDrawProfiling", &UIMap::setRetainedDrawProfiling);
+    g_lua.bindClassMemberFunction<UIMap>("isRetainedDrawProfiling", &UIMap::isRetainedDrawProfiling);
     g_lua.bindClassMemberFunction<UIMap>("setCrosshairTexture", &UIMap::setCrosshairTexture);
     g_lua.bindClassMemberFunction<UIMap>("setDrawHighlightTarget", &UIMap::setDrawHighlightTarget);
     g_lua.bindClassMemberFunction<UIMap>("setAntiAliasingMode", &UIMap::setAntiAliasingMode);
@@ -34,6 +34,7 @@
 #include <framework/core/graphicalapplication.h>
 #include <framework/core/eventdispatcher.h>
 #include <framework/ui/uiwidget.h>
+#include <bit>
 #include <queue>
 
 #ifdef FRAMEWORK_EDITOR
@@ -93,6 +94,17 @@ void Map::notificateTileUpdate(const Position& pos, const ThingPtr& thing, const
     if (!pos.isMapPosition())
         return;
 
+    if (m_tileUpdatesDepth > 0) {
+        if (operation == Otc::OPERATION_CLEAN)
+            m_tileUpdates.cleaned.emplace(pos);
+        else if (operation == Otc::OPERATION_REMOVE && thing && thing->isOpaque())
+            m_tileUpdates.opaqueRemoved = true;
+
+        if (thing && thing->isItem())
+            m_tileUpdates.minimap.emplace(pos);
+        return;
+    }
+
     for (const auto& mapView : m_mapViews) {
         mapView->onTileUpdate(pos, thing, operation);
     }
@@ -102,12 +114,43 @@ void Map::notificateTileUpdate(const Position& pos, const ThingPtr& thing, const
     }
 }
 
+void Map::endTileUpdates()
+{
+    if (m_tileUpdatesDepth == 0 || --m_tileUpdatesDepth > 0)
+        return;
+
+    if (!m_tileUpdates.cleaned.empty() || m_tileUpdates.opaqueRemoved) {
+        for (const auto& mapView : m_mapViews)
+            mapView->onTileUpdates(m_tileUpdates);
+    }
+
+    for (const auto& pos : m_tileUpdates.minimap)
+        g_minimap.updateTile(pos, getTile(pos));
+
+    removeTileStaticTexts(m_tileUpdates.staticTexts);
+
+    m_tileUpdates.cleaned.clear();
+    m_tileUpdates.minimap.clear();
+    m_tileUpdates.staticTexts.clear();
+    m_tileUpdates.opaqueRemoved = false;
+}
+
 void Map::clean()
 {
     cleanDynamicThings();
 
-    for (int_fast8_t i = -1; ++i <= g_gameConfig.getMapMaxZ();)
+    for (int_fast8_t i = -1; ++i <= g_gameConfig.getMapMaxZ();) {
         m_floors[i].tileBlocks.clear();
+        m_floors[i].creatureCells.clear();
+    }
+
+    std::fill(m_tileGrid.begin(), m_tileGrid.end(), nullptr);
+    std::fill(m_opaqueRows.begin(), m_opaqueRows.end(), 0);
+    std::fill(m_topGroundRows.begin(), m_topGroundRows.end(), 0);
+
+    // the views still hold the tiles they evaluated last
+    for (const auto& mapView : m_mapViews)
+        mapView->resetLastCamera();
 
 #ifdef FRAMEWORK_EDITOR
     m_waypoints.clear();
@@ -322,8 +365,143 @@ StaticTextPtr Map::getStaticText(const Position& pos) const
     return nullptr;
 }
 
-const TilePtr& Map::createTile(const Position& pos) { return pos.isMapPosition() ? m_floors[pos.z].tileBlocks[getBlockIndex(pos)].create(pos) : m_nulltile; }
-const TilePtr& Map::getOrCreateTile(const Position& pos) { return pos.isMapPosition() ? m_floors[pos.z].tileBlocks[getBlockIndex(pos)].getOrCreate(pos) : m_nulltile; }
+const TilePtr& Map::createTile(const Position& pos) { return pos.isMapPosition() ? getOrCreateTileBlock(pos).create(pos) : m_nulltile; }
+const TilePtr& Map::getOrCreateTile(const Position& pos) { return pos.isMapPosition() ? getOrCreateTileBlock(pos).getOrCreate(pos) : m_nulltile; }
+
+TileBlock& Map::getOrCreateTileBlock(const Position& pos)
+{
+    const auto& [it, inserted] = m_floors[pos.z].tileBlocks.try_emplace(getBlockIndex(pos));
+    if (inserted) {
+        const int32_t x = pos.x & ~(BLOCK_SIZE - 1);
+        const int32_t y = pos.y & ~(BLOCK_SIZE - 1);
+        refreshTileGrid(pos.z, x, y, x + BLOCK_SIZE - 1, y + BLOCK_SIZE - 1);
+    }
+
+    return it->second;
+}
+
+void Map::moveTileGrid(const Position& centralPosition)
+{
+    const Point origin(centralPosition.x - TILE_GRID_SIZE / 2, centralPosition.y - TILE_GRID_SIZE / 2);
+    const Point oldOrigin = m_tileGridOrigin;
+    const bool fullRefresh = m_tileGrid.empty() || std::abs(origin.x - oldOrigin.x) >= TILE_GRID_SIZE || std::abs(origin.y - oldOrigin.y) >= TILE_GRID_SIZE;
+
+    m_tileGrid.resize(m_floors.size() * TILE_GRID_SIZE * TILE_GRID_SIZE);
+    m_opaqueRows.resize(m_floors.size() * TILE_GRID_SIZE);
+    m_topGroundRows.resize(m_floors.size() * TILE_GRID_SIZE);
+    m_tileGridOrigin = origin;
+
+    const int32_t lastX = origin.x + TILE_GRID_SIZE - 1;
+    const int32_t lastY = origin.y + TILE_GRID_SIZE - 1;
+
+    for (uint8_t z = 0; z < m_floors.size(); ++z) {
+        if (fullRefresh) {
+            refreshTileGrid(z, origin.x, origin.y, lastX, lastY);
+            continue;
+        }
+
+        // only the columns and rows that entered the window point to new positions
+        if (origin.x > oldOrigin.x)
+            refreshTileGrid(z, oldOrigin.x + TILE_GRID_SIZE, origin.y, lastX, lastY);
+        else if (origin.x < oldOrigin.x)
+            refreshTileGrid(z, origin.x, origin.y, oldOrigin.x - 1, lastY);
+
+        if (origin.y > oldOrigin.y)
+            refreshTileGrid(z, origin.x, oldOrigin.y + TILE_GRID_SIZE, lastX, lastY);
+        else if (origin.y < oldOrigin.y)
+            refreshTileGrid(z, origin.x, origin.y, lastX, oldOrigin.y - 1);
+    }
+}
+
+void Map::unlinkTileGridBlock(uint8_t z, const TileBlock& block)
+{
+    if (m_tileGrid.empty())
+        return;
+
+    const auto& tiles = block.getTiles();
+    const int32_t begin = z * TILE_GRID_SIZE * TILE_GRID_SIZE;
+    for (int32_t index = begin; index < begin + TILE_GRID_SIZE * TILE_GRID_SIZE; ++index) {
+        const TilePtr* tile = m_tileGrid[index];
+        if (std::less_equal<const TilePtr*>()(tiles.data(), tile) && std::less<const TilePtr*>()(tile, tiles.data() + tiles.size())) {
+            m_tileGrid[index] = nullptr;
+            setOcclusion(index, nullptr);
+        }
+    }
+}
+
+void Map::refreshTileGrid(uint8_t z, int32_t fromX, int32_t fromY, int32_t toX, int32_t toY)
+{
+    if (m_tileGrid.empty())
+        return;
+
+    fromX = std::max<int32_t>({ fromX, m_tileGridOrigin.x, 0 });
+    fromY = std::max<int32_t>({ fromY, m_tileGridOrigin.y, 0 });
+    toX = std::min<int32_t>({ toX, m_tileGridOrigin.x + TILE_GRID_SIZE - 1, UINT16_MAX });
+    toY = std::min<int32_t>({ toY, m_tileGridOrigin.y + TILE_GRID_SIZE - 1, UINT16_MAX });
+
+    auto& tileBlocks = m_floors[z].tileBlocks;
+    for (int32_t y = fromY; y <= toY; ++y) {
+        for (int32_t x = fromX; x <= toX; ++x) {
+            const Position pos(x, y, z);
+            const auto it = tileBlocks.find(getBlockIndex(pos));
+            const int32_t index = getTileGridIndex(pos);
+            m_tileGrid[index] = it != tileBlocks.end() ? &it->second.get(pos) : nullptr;
+            setOcclusion(index, m_tileGrid[index]);
+        }
+    }
+}
+
+void Map::updateOcclusion(const Position& pos)
+{
+    if (!pos.isMapPosition())
+        return;
+
+    if (const int32_t index = getTileGridIndex(pos); index >= 0)
+        setOcclusion(index, m_tileGrid[index]);
+}
+
+void Map::setOcclusion(int32_t index, const TilePtr* tile)
+{
+    const bool opaque = tile && *tile && (*tile)->isFullyOpaque();
+    const bool topGround = tile && *tile && (*tile)->hasTopGround();
+
+    const uint64_t bit = uint64_t{ 1 } << (index & (TILE_GRID_SIZE - 1));
+    auto& opaqueRow = m_opaqueRows[index >> TILE_GRID_BITS];
+    auto& topGroundRow = m_topGroundRows[index >> TILE_GRID_BITS];
+
+    opaqueRow = opaque ? opaqueRow | bit : opaqueRow & ~bit;
+    topGroundRow = topGround ? topGroundRow | bit : topGroundRow & ~bit;
+}
+
+bool Map::isOccluding(const Position& pos, bool topGround)
+{
+    if (!pos.isMapPosition())
+        return false;
+
+    if (const int32_t index = getTileGridIndex(pos); index >= 0) {
+        const auto& rows = topGround ? m_topGroundRows : m_opaqueRows;
+        return (rows[index >> TILE_GRID_BITS] >> (index & (TILE_GRID_SIZE - 1))) & 1;
+    }
+
+    const auto& tile = getTile(pos);
+    return tile && (topGround ? tile->hasTopGround() : tile->isFullyOpaque());
+}
+
+bool Map::isOpaqueSquare(const Position& pos)
+{
+    // the 2x2 tiles ending at pos
+    const Position& cornerPos = pos.translated(-1, -1);
+    const int32_t index = pos.isMapPosition() ? getTileGridIndex(pos) : -1;
+    const int32_t cornerIndex = cornerPos.isMapPosition() ? getTileGridIndex(cornerPos) : -1;
+    if (index < 0 || cornerIndex < 0) {
+        return isOccluding(pos, false) && isOccluding(pos.translated(-1, 0), false)
+            && isOccluding(pos.translated(0, -1), false) && isOccluding(cornerPos, false);
+    }
+
+    // both columns in each of both rows, wrapping around the toroidal window
+    const uint64_t mask = std::rotl(uint64_t{ 3 }, cornerPos.x & (TILE_GRID_SIZE - 1));
+    return (m_opaqueRows[index >> TILE_GRID_BITS] & m_opaqueRows[cornerIndex >> TILE_GRID_BITS] & mask) == mask;
+}
 
 template <typename... Items>
 const TilePtr& Map::createTileEx(const Position& pos, const Items&... items)
@@ -343,6 +521,11 @@ const TilePtr& Map::getTile(const Position& pos)
     if (!pos.isMapPosition())
         return m_nulltile;
 
+    if (const int32_t index = getTileGridIndex(pos); index >= 0) {
+        const auto* tile = m_tileGrid[index];
+        return tile ? *tile : m_nulltile;
+    }
+
     auto& tileBlocks = m_floors[pos.z].tileBlocks;
 
     const auto it = tileBlocks.find(getBlockIndex(pos));
@@ -394,11 +577,19 @@ void Map::cleanTile(const Position& pos)
                 block.remove(pos);
 
             notificateTileUpdate(pos, nullptr, Otc::OPERATION_CLEAN);
+        } else if (m_tileUpdatesDepth > 0) {
+            m_tileUpdates.minimap.emplace(pos);
         } else {
             g_minimap.updateTile(pos, nullptr);
         }
     }
 
+    // the texts of the batched tiles are removed all at once when it ends
+    if (m_tileUpdatesDepth > 0) {
+        m_tileUpdates.staticTexts.emplace(pos);
+        return;
+    }
+
     for (auto itt = m_staticTexts.begin(); itt != m_staticTexts.end();) {
         const auto& staticText = *itt;
         if (staticText->getPosition() == pos && staticText->getMessageMode() == Otc::MessageNone)
@@ -408,6 +599,16 @@ void Map::cleanTile(const Position& pos)
     }
 }
 
+void Map::removeTileStaticTexts(const stdext::set<Position, Position::Hasher>& positions)
+{
+    if (positions.empty() || m_staticTexts.empty())
+        return;
+
+    std::erase_if(m_staticTexts, [&positions](const StaticTextPtr& staticText) {
+        return staticText->getMessageMode() == Otc::MessageNone && positions.contains(staticText->getPosition());
+    });
+}
+
 #ifdef FRAMEWORK_EDITOR
 void Map::setShowZone(tileflags_t zone, bool show)
 {
@@ -544,9 +745,10 @@ void Map::removeUnawareThings()
                     notificateTileUpdate(pos, nullptr, Otc::OPERATION_CLEAN);
                 }
 
-                if (blockEmpty)
+                if (blockEmpty) {
+                    unlinkTileGridBlock(z, block);
                     it = tileBlocks.erase(it);
-                else
+                } else
                     ++it;
             }
         }
@@ -560,6 +762,7 @@ void Map::setCentralPosition(const Position& centralPosition)
 
     m_centralPosition = centralPosition;
 
+    moveTileGrid(centralPosition);
     removeUnawareThings();
 
     // this fixes local player position when the local player is removed from the map,
@@ -597,9 +800,38 @@ void Map::setLight(const Light& light)
         mapView->onGlobalLightChange(m_light);
 }
 
+void Map::indexCreature(const CreaturePtr& creature, const Position& pos)
+{
+    if (!pos.isMapPosition())
+        return;
+
+    m_floors[pos.z].creatureCells[getCreatureCellIndex(pos.x, pos.y)].emplace_back(creature, pos);
+}
+
+void Map::unindexCreature(const CreaturePtr& creature, const Position& pos)
+{
+    if (!pos.isMapPosition())
+        return;
+
+    auto& cells = m_floors[pos.z].creatureCells;
+    const auto it = cells.find(getCreatureCellIndex(pos.x, pos.y));
+    if (it == cells.end())
+        return;
+
+    auto& cell = it->second;
+    const auto creatureIt = std::find_if(cell.begin(), cell.end(), [&](const auto& entry) { return entry.first == creature && entry.second == pos; });
+    if (creatureIt == cell.end())
+        return;
+
+    *creatureIt = std::move(cell.back());
+    cell.pop_back();
+
+    if (cell.empty())
+        cells.erase(it);
+}
+
 std::vector<CreaturePtr> Map::getSpectatorsInRangeEx(const Position& centerPos, bool multiFloor, int32_t minXRange, int32_t maxXRange, int32_t minYRange, int32_t maxYRange)
 {
-    std::vector<CreaturePtr> creatures;
     uint8_t minZRange = 0;
     uint8_t maxZRange = 0;
 
@@ -608,19 +840,61 @@ std::vector<CreaturePtr> Map::getSpectatorsInRangeEx(const Position& centerPos,
         maxZRange = getLastAwareFloor() - centerPos.z;
     }
 
-    //TODO: optimize
-    //TODO: delivery creatures in distance order
+    const int32_t minX = std::max<int32_t>(centerPos.x - minXRange, 0);
+    const int32_t maxX = std::min<int32_t>(centerPos.x + maxXRange, UINT16_MAX);
+    const int32_t minY = std::max<int32_t>(centerPos.y - minYRange, 0);
+    const int32_t maxY = std::min<int32_t>(centerPos.y + maxYRange, UINT16_MAX);
+
+    std::vector<std::pair<CreaturePtr, Position>> spectators;
+    const auto& collect = [&](const std::vector<std::pair<CreaturePtr, Position>>& cell) {
+        for (const auto& entry : cell) {
+            const auto& pos = entry.second;
+            if (pos.x >= minX && pos.x <= maxX && pos.y >= minY && pos.y <= maxY)
+                spectators.emplace_back(entry);
+        }
+    };
+
     for (int_fast8_t iz = -minZRange; iz <= maxZRange; ++iz) {
-        for (int_fast32_t iy = -minYRange; iy <= maxYRange; ++iy) {
-            for (int_fast32_t ix = -minXRange; ix <= maxXRange; ++ix) {
-                if (const auto& tile = getTile(centerPos.translated(ix, iy, iz))) {
-                    const auto& tileCreatures = tile->getCreatures();
-                    creatures.insert(creatures.end(), tileCreatures.rbegin(), tileCreatures.rend());
-                }
+        const int z = centerPos.z + iz;
+        if (z < 0 || z > g_gameConfig.getMapMaxZ())
+            continue;
+
+        const auto& cells = m_floors[z].creatureCells;
+        if (cells.empty())
+            continue;
+
+        const int32_t firstCellX = minX >> CREATURE_CELL_BITS, lastCellX = maxX >> CREATURE_CELL_BITS;
+        const int32_t firstCellY = minY >> CREATURE_CELL_BITS, lastCellY = maxY >> CREATURE_CELL_BITS;
+
+        // wide ranges over a sparse floor are cheaper to answer by walking the occupied cells
+        if (static_cast<size_t>(lastCellX - firstCellX + 1) * (lastCellY - firstCellY + 1) > cells.size()) {
+            for (const auto& [index, cell] : cells)
+                collect(cell);
+            continue;
+        }
+
+        for (int32_t cellY = firstCellY; cellY <= lastCellY; ++cellY) {
+            for (int32_t cellX = firstCellX; cellX <= lastCellX; ++cellX) {
+                if (const auto it = cells.find(cellX << 16 | cellY); it != cells.end())
+                    collect(it->second);
             }
         }
     }
 
+    // closest first: by floor, then by distance on the floor
+    const auto& distance = [&](const std::pair<CreaturePtr, Position>& entry) {
+        const auto& pos = entry.second;
+        const int dx = pos.x - centerPos.x;
+        const int dy = pos.y - centerPos.y;
+        return std::make_tuple(std::abs(pos.z - centerPos.z), dx * dx + dy * dy, pos.z, pos.y, pos.x, entry.first->getId());
+    };
+    std::sort(spectators.begin(), spectators.end(), [&](const auto& a, const auto& b) { return distance(a) < distance(b); });
+
+    std::vector<CreaturePtr> creatures;
+    creatures.reserve(spectators.size());
+    for (auto& [creature, pos] : spectators)
+        creatures.emplace_back(std::move(creature));
+
     return creatures;
 }
 
@@ -636,15 +910,8 @@ bool Map::isCovered(const Position& pos, uint8_t firstFloor)
     Position tilePos = pos;
     while (tilePos.coveredUp() && tilePos.z >= firstFloor) {
         // the below tile is covered when the above tile has a full opaque
-        if (const auto& tile = getTile(tilePos)) {
-            if (tile->isFullyOpaque())
-                return true;
-        }
-
-        if (const auto& tile = getTile(tilePos.translated(1, 1))) {
-            if (tile->hasTopGround())
-                return true;
-        }
+        if (isOccluding(tilePos, false) || isOccluding(tilePos.translated(1, 1), true))
+            return true;
     }
 
     return false;
@@ -653,44 +920,17 @@ bool Map::isCovered(const Position& pos, uint8_t firstFloor)
 bool Map::isCompletelyCovered(const Position& pos, uint8_t firstFloor)
 {
     const auto& checkTile = getTile(pos);
+    const bool singleDimension = !checkTile || checkTile->isSingleDimension();
+
     Position tilePos = pos;
     while (tilePos.coveredUp() && tilePos.z >= firstFloor) {
-        bool covered = true;
-        bool done = false;
-
-        // Check is Top Ground
-        for (int_fast8_t x = -1; ++x < 2 && !done;) {
-            for (int_fast8_t y = -1; ++y < 2 && !done;) {
-                const auto& tile = getTile(tilePos.translated(x, x));
-                if (!tile || !tile->hasTopGround()) {
-                    covered = false;
-                    done = true;
-                } else if (x == 1 && y == 1 && (!checkTile || checkTile->isSingleDimension())) {
-                    done = true;
-                }
-            }
-        }
-
-        if (covered)
+        // Check is Top Ground, on the tile and on its diagonal
+        if (isOccluding(tilePos, true) && isOccluding(tilePos.translated(1, 1), true))
             return true;
 
-        covered = true;
-        done = false;
-
-        // check in 2x2 range tiles that has no transparent pixels
-        for (int_fast8_t x = -1; ++x < 2 && !done;) {
-            for (int_fast8_t y = -1; ++y < 2 && !done;) {
-                const auto& tile = getTile(tilePos.translated(-x, -y));
-                if (!tile || !tile->isFullyOpaque()) {
-                    covered = false;
-                    done = true;
-                } else if (x == 0 && y == 0 && (!checkTile || checkTile->isSingleDimension())) {
-                    done = true;
-                }
-            }
-        }
-
-        if (covered)
+        // check in 2x2 range tiles that has no transparent pixels,
+        // a single dimension tile only needs the one right above it
+        if (singleDimension ? isOccluding(tilePos, false) : isOpaqueSquare(tilePos))
             return true;
     }
     return false;
@@ -755,24 +995,6 @@ std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> Map::findPath(const
 {
     // pathfinding using dijkstra search algorithm
 
-    struct SNode
-    {
-        SNode(const Position& pos) : cost(0), totalCost(0), pos(pos), prev(nullptr), dir(Otc::InvalidDirection) {}
-        float cost;
-        float totalCost;
-        Position pos;
-        SNode* prev;
-        Otc::Direction dir;
-    };
-
-    struct LessNode
-    {
-        bool operator()(std::pair<SNode*, float> a, std::pair<SNode*, float> b) const
-        {
-            return b.second < a.second;
-        }
-    };
-
     std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> ret;
     std::vector<Otc::Direction>& dirs = std::get<0>(ret);
     Otc::PathFindResult& result = std::get<1>(ret);
@@ -802,15 +1024,14 @@ std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> Map::findPath(const
         }
     }
 
-    stdext::map<Position, SNode*, Position::Hasher> nodes;
-    std::priority_queue<std::pair<SNode*, float>, std::vector<std::pair<SNode*, float>>, LessNode> searchList;
+    auto& arena = PathFindingArena::get();
+    arena.reset();
 
-    auto* currentNode = new SNode(startPos);
-    currentNode->pos = startPos;
-    nodes[startPos] = currentNode;
-    SNode* foundNode = nullptr;
+    bool inserted;
+    auto* currentNode = arena.visit(startPos, inserted) = arena.createNode({ 0, 0, startPos, nullptr, 0, 0 });
+    Node* foundNode = nullptr;
     while (currentNode) {
-        if (static_cast<int>(nodes.size()) > maxComplexity) {
+        if (static_cast<int>(arena.getVisitedCount()) > maxComplexity) {
             result = Otc::PathFindResultTooFar;
             break;
         }
@@ -883,45 +1104,29 @@ std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> Map::findPath(const
 
                 const float cost = currentNode->cost + (speed * walkFactor) / 100.0f;
 
-                SNode* neighborNode;
-                if (!nodes.contains(neighborPos)) {
-                    neighborNode = new SNode(neighborPos);
-                    nodes[neighborPos] = neighborNode;
-                } else {
-                    neighborNode = nodes[neighborPos];
-                    if (neighborNode->cost <= cost)
-                        continue;
-                }
+                auto*& neighborNode = arena.visit(neighborPos, inserted);
+                if (inserted)
+                    neighborNode = arena.createNode({ 0, 0, neighborPos, nullptr, 0, 0 });
+                else if (neighborNode->cost <= cost)
+                    continue;
 
                 neighborNode->prev = currentNode;
                 neighborNode->cost = cost;
                 neighborNode->totalCost = neighborNode->cost + neighborPos.distance(goalPos);
-                neighborNode->dir = walkDir;
-                searchList.push(std::make_pair(neighborNode, neighborNode->totalCost));
+                arena.push(neighborNode);
             }
         }
 
-        if (!searchList.empty()) {
-            currentNode = searchList.top().first;
-            searchList.pop();
-        } else
-            currentNode = nullptr;
+        currentNode = arena.empty() ? nullptr : arena.pop();
     }
 
     if (foundNode) {
-        currentNode = foundNode;
-        while (currentNode) {
-            dirs.push_back(currentNode->dir);
-            currentNode = currentNode->prev;
-        }
-        dirs.pop_back();
+        for (currentNode = foundNode; currentNode->prev; currentNode = currentNode->prev)
+            dirs.push_back(currentNode->prev->pos.getDirectionFromPosition(currentNode->pos));
         std::reverse(dirs.begin(), dirs.end());
         result = Otc::PathFindResultOk;
     }
 
-    for (const auto& it : nodes)
-        delete it.second;
-
     return ret;
 }
 
@@ -931,8 +1136,7 @@ void Map::resetLastCamera() const
         mapView->resetLastCamera();
 }
 
-PathFindResult_ptr Map::newFindPath(const Position& start, const Position& goal, const std::shared_ptr<std::list<Node*>>
-                                    & visibleNodes)
+PathFindResult_ptr Map::newFindPath(const Position& start, const Position& goal, const std::shared_ptr<std::vector<Node>>& visibleNodes)
 {
     auto ret = std::make_shared<PathFindResult>();
     ret->start = start;
@@ -960,33 +1164,27 @@ PathFindResult_ptr Map::newFindPath(const Position& start, const Position& goal,
         }
     }
 
-    struct LessNode
-    {
-        bool operator()(Node const* a, Node const* b) const
-        {
-            return b->totalCost < a->totalCost;
-        }
-    };
-
-    stdext::map<Position, Node*, Position::Hasher> nodes;
-    std::priority_queue<Node*, std::vector<Node*>, LessNode> searchList;
+    auto& arena = PathFindingArena::get();
+    arena.reset();
 
+    bool inserted;
     if (visibleNodes) {
-        for (auto& node : *visibleNodes)
-            nodes.emplace(node->pos, node);
+        for (const auto& node : *visibleNodes) {
+            auto*& visibleNode = arena.visit(node.pos, inserted);
+            if (inserted)
+                visibleNode = arena.createNode(node);
+        }
     }
 
-    const auto& initNode = new Node{ 1, 0, start, nullptr, 0, 0 };
-    nodes[start] = initNode;
-    searchList.push(initNode);
+    auto* initNode = arena.visit(start, inserted) = arena.createNode({ 1, 0, start, nullptr, 0, 0 });
+    arena.push(initNode);
 
     int limit = 50000;
     const float distance = start.distance(goal);
 
     Node* dstNode = nullptr;
-    while (!searchList.empty() && --limit) {
-        Node* node = searchList.top();
-        searchList.pop();
+    while (!arena.empty() && --limit) {
+        Node* node = arena.pop();
         if (node->pos == goal) {
             dstNode = node;
             break;
@@ -999,38 +1197,36 @@ PathFindResult_ptr Map::newFindPath(const Position& start, const Position& goal,
                     continue;
                 Position neighbor = node->pos.translated(i, j);
                 if (neighbor.x < 0 || neighbor.y < 0) continue;
-                auto it = nodes.find(neighbor);
-                if (it == nodes.end()) {
+                auto*& neighborNode = arena.visit(neighbor, inserted);
+                if (inserted) {
                     const auto& [block, tile] = g_minimap.threadGetTile(neighbor);
                     const bool wasSeen = tile.hasFlag(MinimapTileWasSeen);
                     const bool isNotWalkable = tile.hasFlag(MinimapTileNotWalkable);
                     const bool isNotPathable = tile.hasFlag(MinimapTileNotPathable);
                     const bool isEmpty = tile.hasFlag(MinimapTileEmpty);
                     float speed = tile.getSpeed();
-                    if ((isNotWalkable || isNotPathable || isEmpty) && neighbor != goal) {
-                        it = nodes.emplace(neighbor, nullptr).first;
-                    } else {
+                    if (!(isNotWalkable || isNotPathable || isEmpty) || neighbor == goal) {
                         if (!wasSeen)
                             speed = 2000;
-                        it = nodes.emplace(neighbor, new Node{ speed, 10000000.0f, neighbor, node, node->distance + 1, wasSeen ? 0 : 1 }).first;
+                        neighborNode = arena.createNode({ speed, 10000000.0f, neighbor, node, node->distance + 1, wasSeen ? 0 : 1 });
                     }
                 }
-                if (!it->second) // no way
+                if (!neighborNode) // no way
                     continue;
 
-                if (it->second->unseen > 50)
+                if (neighborNode->unseen > 50)
                     continue;
 
                 const float diagonal = ((i == 0 || j == 0) ? 1.0f : 3.0f);
-                float cost = it->second->cost * diagonal;
-                cost += diagonal * (50.0f * std::max<float>(5.0f, it->second->pos.distance(goal))); // heuristic
-                if (node->totalCost + cost + 50 < it->second->totalCost) {
-                    it->second->totalCost = node->totalCost + cost;
-                    it->second->prev = node;
-                    if (it->second->unseen)
-                        it->second->unseen = node->unseen + 1;
-                    it->second->distance = node->distance + 1;
-                    searchList.push(it->second);
+                float cost = neighborNode->cost * diagonal;
+                cost += diagonal * (50.0f * std::max<float>(5.0f, neighborNode->pos.distance(goal))); // heuristic
+                if (node->totalCost + cost + 50 < neighborNode->totalCost) {
+                    neighborNode->totalCost = node->totalCost + cost;
+                    neighborNode->prev = node;
+                    if (neighborNode->unseen)
+                        neighborNode->unseen = node->unseen + 1;
+                    neighborNode->distance = node->distance + 1;
+                    arena.push(neighborNode);
                 }
             }
         }
@@ -1050,32 +1246,38 @@ PathFindResult_ptr Map::newFindPath(const Position& start, const Position& goal,
     }
     ret->complexity = 50000 - limit;
 
-    for (const auto& node : nodes) {
-        delete node.second;
-    }
-
     return ret;
 }
 
 void Map::findPathAsync(const Position& start, const Position& goal, const std::function<void(PathFindResult_ptr)>&
                         callback)
 {
-    const auto visibleNodes = std::make_shared<std::list<Node*>>();
-    for (const auto& tile : getTiles(start.z)) {
+    const auto& tiles = getTiles(start.z);
+
+    const auto visibleNodes = std::make_shared<std::vector<Node>>();
+    visibleNodes->reserve(tiles.size());
+    for (const auto& tile : tiles) {
         if (tile->getPosition() == start)
             continue;
         const bool isNotWalkable = !tile->isWalkable(false);
         const bool isNotPathable = !tile->isPathable();
         const float speed = tile->getGroundSpeed();
         if ((isNotWalkable || isNotPathable) && tile->getPosition() != goal) {
-            visibleNodes->push_back(new Node{ speed, 0, tile->getPosition(), nullptr, 0, 0 });
+            visibleNodes->push_back({ speed, 0, tile->getPosition(), nullptr, 0, 0 });
         } else {
-            visibleNodes->push_back(new Node{ speed, 10000000.0f, tile->getPosition(), nullptr, 0, 0 });
+            visibleNodes->push_back({ speed, 10000000.0f, tile->getPosition(), nullptr, 0, 0 });
         }
     }
 
+    // destinations out of the screen are first routed through the minimap clusters
+    const bool longRange = !isAwareOfPosition(goal);
+
     g_asyncDispatcher.dispatch([=] {
-        const auto ret = g_map.newFindPath(start, goal, visibleNodes);
+        PathFindResult_ptr ret;
+        if (longRange)
+            ret = g_minimap.findPath(start, goal);
+        if (!ret || ret->status != Otc::PathFindResultOk)
+            ret = g_map.newFindPath(start, goal, visibleNodes);
         g_dispatcher.addEvent(std::bind(callback, ret));
     });
 }
@@ -1216,13 +1418,6 @@ void Map::updateAttachedWidgets(const MapViewPtr& mapView)
 std::map<std::string, std::tuple<int, int, int, std::string>> Map::findEveryPath(const Position& start, int maxDistance, const std::map<std::string, std::string>& params)
 {
     // using Dijkstra's algorithm
-    struct LessNode
-    {
-        bool operator()(Node* a, Node* b) const
-        {
-            return b->totalCost < a->totalCost;
-        }
-    };
 
     std::map<std::string, std::string>::const_iterator it;
     it = params.find("ignoreLastCreature");
@@ -1267,16 +1462,15 @@ std::map<std::string, std::tuple<int, int, int, std::string>> Map::findEveryPath
     }
 
     std::map<std::string, std::tuple<int, int, int, std::string>> ret;
-    std::unordered_map<Position, Node*, Position::Hasher> nodes;
-    std::priority_queue<Node*, std::vector<Node*>, LessNode> searchList;
+    auto& arena = PathFindingArena::get();
+    arena.reset();
 
-    Node* initNode = new Node{ 1, 0, start, nullptr, 0, 0 };
-    nodes[start] = initNode;
-    searchList.push(initNode);
+    bool inserted;
+    auto* initNode = arena.visit(start, inserted) = arena.createNode({ 1, 0, start, nullptr, 0, 0 });
+    arena.push(initNode);
 
-    while (!searchList.empty()) {
-        Node* node = searchList.top();
-        searchList.pop();
+    while (!arena.empty()) {
+        Node* node = arena.pop();
         ret[node->pos.toString()] = std::make_tuple(node->totalCost, node->distance,
                                                     node->prev ? node->prev->pos.getDirectionFromPosition(node->pos) : -1,
                                                     node->prev ? node->prev->pos.toString() : "");
@@ -1295,8 +1489,8 @@ std::map<std::string, std::tuple<int, int, int, std::string>> Map::findEveryPath
                     continue;
                 Position neighbor = node->pos.translated(i, j);
                 if (neighbor.x < 0 || neighbor.y < 0) continue;
-                auto it = nodes.find(neighbor);
-                if (it == nodes.end()) {
+                auto*& neighborNode = arena.visit(neighbor, inserted);
+                if (inserted) {
                     bool wasSeen = false;
                     bool hasCreature = false;
                     bool isNotWalkable = true;
@@ -1327,44 +1521,39 @@ std::map<std::string, std::tuple<int, int, int, std::string>> Map::findEveryPath
                     if ((!wasSeen && !allowUnseen) || (hasStairs && !ignoreStairs && neighbor != destPos) ||
                         (isNotPathable && !ignoreNonPathable && neighbor != destPos) || (isNotWalkable && !ignoreNonWalkable) ||
                         hasReachedMaxDistance) {
-                        it = nodes.emplace(neighbor, nullptr).first;
+                        neighborNode = nullptr;
                     } else if ((hasCreature && !ignoreCreatures)) {
-                        it = nodes.emplace(neighbor, nullptr).first;
+                        neighborNode = nullptr;
                         if (ignoreLastCreature) {
                             ret[neighbor.toString()] = std::make_tuple(node->totalCost + 100, node->distance + 1,
                                                                        node->pos.getDirectionFromPosition(neighbor),
                                                                        node->pos.toString());
                         }
                     } else {
-                        it = nodes.emplace(neighbor, new Node{ (float)speed, 10000000.0f, neighbor, node, node->distance + 1, wasSeen ? 0 : 1 }).first;
+                        neighborNode = arena.createNode({ (float)speed, 10000000.0f, neighbor, node, node->distance + 1, wasSeen ? 0 : 1 });
                     }
                 }
 
-                if (!it->second) {
+                if (!neighborNode) {
                     continue;
                 }
 
                 float diagonal = ((i == 0 || j == 0) ? 1.0f : 3.0f);
-                float cost = it->second->cost * diagonal;
+                float cost = neighborNode->cost * diagonal;
                 if (ignoreCost)
                     cost = 1;
-                if (node->totalCost + cost < it->second->totalCost) {
-                    it->second->totalCost = node->totalCost + cost;
-                    it->second->prev = node;
-                    if (it->second->unseen)
-                        it->second->unseen = node->unseen + 1;
-                    it->second->distance = node->distance + 1;
-                    searchList.push(it->second);
+                if (node->totalCost + cost < neighborNode->totalCost) {
+                    neighborNode->totalCost = node->totalCost + cost;
+                    neighborNode->prev = node;
+                    if (neighborNode->unseen)
+                        neighborNode->unseen = node->unseen + 1;
+                    neighborNode->distance = node->distance + 1;
+                    arena.push(neighborNode);
                 }
             }
         }
     }
 
-    for (auto& node : nodes) {
-        if (node.second)
-            delete node.second;
-    }
-
     return ret;
 }
 
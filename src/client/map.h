@@ -23,6 +23,7 @@
 #pragma once
 
 #include "animatedtext.h"
+#include "pathfinding.h"
 #include "tile.h"
 
 #ifdef FRAMEWORK_EDITOR
@@ -105,14 +106,14 @@ public:
     const TilePtr& create(const Position& pos)
     {
         auto& tile = m_tiles[getTileIndex(pos)];
-        tile = std::make_shared<Tile>(pos);
+        tile = stdext::make_pooled<Tile>(pos);
         return tile;
     }
     const TilePtr& getOrCreate(const Position& pos)
     {
         auto& tile = m_tiles[getTileIndex(pos)];
         if (!tile)
-            tile = std::make_shared<Tile>(pos);
+            tile = stdext::make_pooled<Tile>(pos);
         return tile;
     }
     const TilePtr& get(const Position& pos) { return m_tiles[getTileIndex(pos)]; }
@@ -126,24 +127,13 @@ private:
     std::array<TilePtr, BLOCK_SIZE* BLOCK_SIZE> m_tiles;
 };
 
-struct PathFindResult
+// Tile updates coalesced while parsing a packet, see Map::beginTileUpdates
+struct TileUpdateBatch
 {
-    Otc::PathFindResult status = Otc::PathFindResultNoWay;
-    std::vector<Otc::Direction> path;
-    int complexity = 0;
-    Position start;
-    Position destination;
-};
-using PathFindResult_ptr = std::shared_ptr<PathFindResult>;
-
-struct Node
-{
-    float cost;
-    float totalCost;
-    Position pos;
-    Node* prev;
-    int distance;
-    int unseen;
+    stdext::set<Position, Position::Hasher> cleaned;
+    stdext::set<Position, Position::Hasher> minimap;
+    stdext::set<Position, Position::Hasher> staticTexts; // positions whose texts are removed
+    bool opaqueRemoved{ false };
 };
 
 //@bindsingleton g_map
@@ -158,6 +148,11 @@ public:
     MapViewPtr getMapView(size_t i) { return i < m_mapViews.size() ? m_mapViews[i] : nullptr; }
 
     void notificateTileUpdate(const Position& pos, const ThingPtr& thing, Otc::Operation operation);
+
+    // updates done between these calls reach the map views and the minimap
+    // once per tile, when the outermost batch ends
+    void beginTileUpdates() { ++m_tileUpdatesDepth; }
+    void endTileUpdates();
     void notificateCameraMove(const Point& offset) const;
     void notificateKeyRelease(const InputEvent& inputEvent) const;
 
@@ -245,6 +240,13 @@ public:
     void addCreature(const CreaturePtr& creature);
     void removeCreatureById(uint32_t id);
 
+    // called by tiles when a creature is placed on or taken from them
+    void indexCreature(const CreaturePtr& creature, const Position& pos);
+    void unindexCreature(const CreaturePtr& creature, const Position& pos);
+
+    // called by tiles when their items change, keeps the occlusion bitmaps up to date
+    void updateOcclusion(const Position& pos);
+
     std::vector<CreaturePtr> getSpectators(const Position& centerPos, bool multiFloor)
     {
         return getSpectatorsInRangeEx(centerPos, multiFloor, m_awareRange.left, m_awareRange.right, m_awareRange.top, m_awareRange.bottom);
@@ -288,7 +290,7 @@ public:
 
     std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> findPath(const Position& start, const Position& goal,
                                                                           int maxComplexity, int flags = 0);
-    PathFindResult_ptr newFindPath(const Position& start, const Position& goal, const std::shared_ptr<std::list<Node*>>& visibleNodes);
+    PathFindResult_ptr newFindPath(const Position& start, const Position& goal, const std::shared_ptr<std::vector<Node>>& visibleNodes);
     void findPathAsync(const Position& start, const Position& goal,
                        const std::function<void(PathFindResult_ptr)>& callback);
 
@@ -306,22 +308,68 @@ public:
     const auto& getCreatures() const { return m_knownCreatures; }
 
 private:
+    // creatures are indexed by cells of CREATURE_CELL_SIZE x CREATURE_CELL_SIZE tiles,
+    // so spectator queries don't have to visit every tile in range.
+    static constexpr uint8_t CREATURE_CELL_BITS = 3;
+    static constexpr uint16_t CREATURE_CELL_SIZE = 1 << CREATURE_CELL_BITS;
+
     struct FloorData
     {
         std::vector<MissilePtr> missiles;
         std::unordered_map<uint32_t, TileBlock > tileBlocks;
+        stdext::map<uint32_t, std::vector<std::pair<CreaturePtr, Position>>> creatureCells;
     };
 
+    static uint32_t getCreatureCellIndex(uint16_t x, uint16_t y) { return (x >> CREATURE_CELL_BITS) << 16 | (y >> CREATURE_CELL_BITS); }
+
+    // Dense toroidal window of TILE_GRID_SIZE x TILE_GRID_SIZE tiles on every floor around
+    // the central position. Cells point to the tile slots of their blocks, so creating or
+    // removing a tile needs no update; only new or erased blocks and moving the window do.
+    static constexpr uint8_t TILE_GRID_BITS = 6;
+    static constexpr int32_t TILE_GRID_SIZE = 1 << TILE_GRID_BITS;
+
+    int32_t getTileGridIndex(const Position& pos) const
+    {
+        const int32_t x = pos.x - m_tileGridOrigin.x;
+        const int32_t y = pos.y - m_tileGridOrigin.y;
+        if (m_tileGrid.empty() || x < 0 || y < 0 || x >= TILE_GRID_SIZE || y >= TILE_GRID_SIZE)
+            return -1;
+
+        return ((pos.z << TILE_GRID_BITS | (pos.y & (TILE_GRID_SIZE - 1))) << TILE_GRID_BITS) | (pos.x & (TILE_GRID_SIZE - 1));
+    }
+
+    TileBlock& getOrCreateTileBlock(const Position& pos);
+    void moveTileGrid(const Position& centralPosition);
+    void refreshTileGrid(uint8_t z, int32_t fromX, int32_t fromY, int32_t toX, int32_t toY);
+    void unlinkTileGridBlock(uint8_t z, const TileBlock& block);
+
+    // Occlusion bitmaps of the tile grid: one word per row, bit x set when the tile is
+    // fully opaque or has top ground, so the covering tests don't have to look up tiles.
+    static_assert(TILE_GRID_SIZE == 64, "a tile grid row must fit in an uint64_t");
+
+    void setOcclusion(int32_t index, const TilePtr* tile);
+    bool isOccluding(const Position& pos, bool topGround);
+    bool isOpaqueSquare(const Position& pos);
+
     void removeUnawareThings();
+    void removeTileStaticTexts(const stdext::set<Position, Position::Hasher>& positions);
 
     uint16_t getBlockIndex(const Position& pos) { return ((pos.y / BLOCK_SIZE) * (65536 / BLOCK_SIZE)) + (pos.x / BLOCK_SIZE); }
 
     std::vector<FloorData> m_floors;
 
+    std::vector<const TilePtr*> m_tileGrid;
+    std::vector<uint64_t> m_opaqueRows;
+    std::vector<uint64_t> m_topGroundRows;
+    Point m_tileGridOrigin;
+
     std::vector<AnimatedTextPtr> m_animatedTexts;
     std::vector<StaticTextPtr> m_staticTexts;
     std::vector<MapViewPtr> m_mapViews;
 
+    uint16_t m_tileUpdatesDepth{ 0 };
+    TileUpdateBatch m_tileUpdates;
+
     std::unordered_map<uint32_t, CreaturePtr> m_knownCreatures;
 
     std::unordered_map<UIWidgetPtr, AttachableObjectPtr> m_attachedObjectWidgetMap;
@@ -352,3 +400,10 @@ private:
 };
 
 extern Map g_map;
+
+// Batches the tile updates done during its lifetime
+struct TileUpdateScope
+{
+    TileUpdateScope() { g_map.beginTileUpdates(); }
+    ~TileUpdateScope() { g_map.endTileUpdates(); }
+};
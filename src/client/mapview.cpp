@@ -136,6 +136,10 @@ void MapView::drawFloor()
 
     uint32_t flags = Otc::DrawThings;
     if (lightView) flags |= Otc::DrawLights;
+    if (m_retainedDraw) flags |= Otc::DrawRetained;
+
+    Tile::retainedDrawStats = {};
+    Tile::retainedDrawProfiling = m_retainedDrawProfiling;
 
     for (int_fast8_t z = m_floorMax; z >= m_floorMin; --z) {
         const float fadeLevel = getFadeLevel(z);
@@ -188,6 +192,8 @@ void MapView::drawFloor()
         g_drawPool.flush();
     }
 
+    m_retainedDrawStats = Tile::retainedDrawStats;
+
     if (m_posInfo.rect.contains(g_window.getMousePosition())) {
         if (m_crosshairTexture && m_mousePosition.isValid()) {
             const auto& point = transformPositionTo2D(m_mousePosition);
@@ -280,6 +286,9 @@ void MapView::updateVisibleTiles()
     if (!m_posInfo.camera.isValid())
         return;
 
+    const stdext::timer updateTimer;
+    const Position previousCamera = m_lastCameraPosition;
+
     // clear current visible tiles cache
     do {
         m_floors[m_floorMin].cachedVisibleTiles.clear();
@@ -331,63 +340,172 @@ void MapView::updateVisibleTiles()
     destroyHighlightTile();
 
     const bool fadeFinished = getFadeLevel(m_cachedFirstVisibleFloor) == 1.f;
+    const bool prefetchSheets = g_game.isUsingProtobuf();
+    const bool drawingLights = isDrawingLights();
+
+    const int width = m_drawDimension.width();
+    const int height = m_drawDimension.height();
+
+    // evaluated tiles are kept in a toroidal grid per floor, indexed by the position
+    // on the camera floor, so moving the camera keeps the cells it still sees.
+    const auto& getCellIndex = [&](int x, int y) {
+        return ((y % height + height) % height) * width + ((x % width + width) % width);
+    };
+
+    const auto& updateCell = [&](int iz, int ix, int iy) {
+        const int x = m_posInfo.camera.x + ix - m_virtualCenterOffset.x;
+        const int y = m_posInfo.camera.y + iy - m_virtualCenterOffset.y;
+
+        auto& cell = m_floors[iz].visibleCells[getCellIndex(x, y)];
+        cell = {};
+
+        // position on current floor
+        //TODO: check position limits
+        Position tilePos = m_posInfo.camera.translated(ix - m_virtualCenterOffset.x, iy - m_virtualCenterOffset.y);
+        // adjust tilePos to the wanted floor
+        tilePos.coveredUp(m_posInfo.camera.z - iz);
+        const auto& tile = g_map.getTile(tilePos);
+
+        // skip tiles that have nothing
+        if (!tile || !tile->isDrawable())
+            return;
+
+        bool addTile = true;
+
+        if (fadeFinished) {
+            // skip tiles that are completely behind another tile
+            if (tile->isCompletelyCovered(m_cachedFirstVisibleFloor, m_resetCoveredCache)) {
+                if (m_floorViewMode != ALWAYS_WITH_TRANSPARENCY || (tilePos.z < m_posInfo.camera.z && tile->isCovered(m_cachedFirstVisibleFloor))) {
+                    addTile = false;
+                }
+            }
+        }
+
+        // start decoding the sprite sheets on async workers before the tile is drawn
+        if (addTile && prefetchSheets) {
+            for (const auto& thing : tile->getThings()) {
+                if (const auto type = thing->getThingType())
+                    type->prefetchSpriteSheets();
+            }
+        }
+
+        const bool shade = drawingLights && tile->canShade();
+        if (addTile || shade)
+            cell = { tile, addTile, shade };
+    };
+
+    const VisibleTilesState state{ m_posInfo.camera.z, cachedFirstVisibleFloor, m_cachedFirstVisibleFloor, m_cachedLastVisibleFloor,
+        m_floorViewMode, fadeFinished, drawingLights, m_drawDimension };
+
+    const int dx = m_posInfo.camera.x - previousCamera.x;
+    const int dy = m_posInfo.camera.y - previousCamera.y;
+
+    // single steps (or any move smaller than the view) only need the uncovered rows and columns,
+    // everything else that could change the visibility of the kept cells rebuilds the whole grid.
+    const bool incremental = m_visibleTilesState && *m_visibleTilesState == state && previousCamera.isValid() && !m_resetCoveredCache
+        && std::abs(dx) < width && std::abs(dy) < height;
+
+    for (int_fast32_t iz = m_cachedLastVisibleFloor; iz >= cachedFirstVisibleFloor; --iz) {
+        auto& cells = m_floors[iz].visibleCells;
+        if (!incremental) {
+            cells.assign(static_cast<size_t>(width) * height, {});
+            for (int iy = 0; iy < height; ++iy) {
+                for (int ix = 0; ix < width; ++ix)
+                    updateCell(iz, ix, iy);
+            }
+            continue;
+        }
+
+        for (int iy = 0; iy < height; ++iy) {
+            const bool newRow = dy > 0 ? iy >= height - dy : iy < -dy;
+            for (int ix = 0; ix < width; ++ix) {
+                if (newRow || (dx > 0 ? ix >= width - dx : ix < -dx))
+                    updateCell(iz, ix, iy);
+            }
+        }
+    }
+
+    if (incremental) {
+        // tiles that changed since the last update
+        for (const auto& pos : m_dirtyVisibleTiles) {
+            if (pos.z < cachedFirstVisibleFloor || pos.z > m_cachedLastVisibleFloor)
+                continue;
+
+            const int ix = pos.x - (m_posInfo.camera.z - pos.z) - m_posInfo.camera.x + m_virtualCenterOffset.x;
+            const int iy = pos.y - (m_posInfo.camera.z - pos.z) - m_posInfo.camera.y + m_virtualCenterOffset.y;
+            if (ix >= 0 && ix < width && iy >= 0 && iy < height)
+                updateCell(pos.z, ix, iy);
+        }
+    }
+
+    m_dirtyVisibleTiles.clear();
+    m_visibleTilesState = state;
 
     // cache visible tiles in draw order
     // draw from last floor (the lower) to first floor (the higher)
-    const uint32_t numDiagonals = m_drawDimension.width() + m_drawDimension.height() - 1;
+    const uint32_t numDiagonals = width + height - 1;
     for (int_fast32_t iz = m_cachedLastVisibleFloor; iz >= cachedFirstVisibleFloor; --iz) {
         auto& floor = m_floors[iz].cachedVisibleTiles;
+        const auto& cells = m_floors[iz].visibleCells;
 
         // loop through / diagonals beginning at top left and going to top right
         for (uint_fast32_t diagonal = 0; diagonal < numDiagonals; ++diagonal) {
             // loop current diagonal tiles
-            const uint32_t advance = std::max<uint32_t >(diagonal - m_drawDimension.height(), 0);
-            for (int iy = diagonal - advance, ix = advance; iy >= 0 && ix < m_drawDimension.width(); --iy, ++ix) {
-                // position on current floor
-                //TODO: check position limits
-                Position tilePos = m_posInfo.camera.translated(ix - m_virtualCenterOffset.x, iy - m_virtualCenterOffset.y);
-                // adjust tilePos to the wanted floor
-                tilePos.coveredUp(m_posInfo.camera.z - iz);
-                if (const auto& tile = g_map.getTile(tilePos)) {
-                    // skip tiles that have nothing
-                    if (!tile->isDrawable())
-                        continue;
-
-                    bool addTile = true;
-
-                    if (fadeFinished) {
-                        // skip tiles that are completely behind another tile
-                        if (tile->isCompletelyCovered(m_cachedFirstVisibleFloor, m_resetCoveredCache)) {
-                            if (m_floorViewMode != ALWAYS_WITH_TRANSPARENCY || (tilePos.z < m_posInfo.camera.z && tile->isCovered(m_cachedFirstVisibleFloor))) {
-                                addTile = false;
-                            }
-                        }
-                    }
+            const uint32_t advance = std::max<uint32_t >(diagonal - height, 0);
+            for (int iy = diagonal - advance, ix = advance; iy >= 0 && ix < width; --iy, ++ix) {
+                const auto& cell = cells[getCellIndex(m_posInfo.camera.x + ix - m_virtualCenterOffset.x, m_posInfo.camera.y + iy - m_virtualCenterOffset.y)];
+                if (!cell.tile)
+                    continue;
 
-                    if (addTile) {
-                        floor.tiles.emplace_back(tile);
-                        tile->onAddInMapView();
-                    }
+                if (cell.draw) {
+                    floor.tiles.emplace_back(cell.tile);
+                    cell.tile->onAddInMapView();
+                }
 
-                    if (isDrawingLights() && tile->canShade())
-                        floor.shades.emplace_back(tile);
+                if (cell.shade)
+                    floor.shades.emplace_back(cell.tile);
 
-                    if (addTile || !floor.shades.empty()) {
-                        if (iz < m_floorMin)
-                            m_floorMin = iz;
-                        else if (iz > m_floorMax)
-                            m_floorMax = iz;
-                    }
+                if (cell.draw || !floor.shades.empty()) {
+                    if (iz < m_floorMin)
+                        m_floorMin = iz;
+                    else if (iz > m_floorMax)
+                        m_floorMax = iz;
                 }
             }
         }
     }
 
+    auto& stats = incremental ? m_visibleTilesStats.incremental : m_visibleTilesStats.full;
+    ++stats.updates;
+    stats.micros += updateTimer.elapsed_micros();
+
     m_updateVisibleTiles = false;
     m_resetCoveredCache = false;
     updateHighlightTile(m_mousePosition);
 }
 
+std::map<std::string, uint64_t> MapView::getVisibleTilesStats()
+{
+    return {
+        { "fullUpdates", m_visibleTilesStats.full.updates },
+        { "fullMicros", m_visibleTilesStats.full.micros },
+        { "incrementalUpdates", m_visibleTilesStats.incremental.updates },
+        { "incrementalMicros", m_visibleTilesStats.incremental.micros }
+    };
+}
+
+std::map<std::string, uint64_t> MapView::getRetainedDrawStats()
+{
+    return {
+        { "staticCommands", m_retainedDrawStats.staticCommands },
+        { "staticMicros", m_retainedDrawStats.staticMicros },
+        { "animatedCommands", m_retainedDrawStats.animatedCommands },
+        { "animatedMicros", m_retainedDrawStats.animatedMicros },
+        { "liveThings", m_retainedDrawStats.liveThings },
+        { "liveMicros", m_retainedDrawStats.liveMicros }
+    };
+}
+
 void MapView::updateRect(const Rect& rect) {
     if (m_posInfo.rect != rect || m_updateMapPosInfo) {
         m_updateMapPosInfo = false;
@@ -494,6 +612,9 @@ void MapView::onTileUpdate(const Position& pos, const ThingPtr& thing, const Otc
     if (thing && thing->isOpaque() && op == Otc::OPERATION_REMOVE)
         m_resetCoveredCache = true;
 
+    if (op != Otc::OPERATION_REMOVE && m_visibleTilesState)
+        m_dirtyVisibleTiles.emplace(pos);
+
     if (op == Otc::OPERATION_CLEAN) {
         if (m_lastHighlightTile && m_lastHighlightTile->getPosition() == pos)
             m_lastHighlightTile = nullptr;
@@ -502,6 +623,22 @@ void MapView::onTileUpdate(const Position& pos, const ThingPtr& thing, const Otc
     }
 }
 
+void MapView::onTileUpdates(const TileUpdateBatch& updates)
+{
+    if (updates.opaqueRemoved)
+        m_resetCoveredCache = true;
+
+    if (!updates.cleaned.empty()) {
+        if (m_visibleTilesState)
+            m_dirtyVisibleTiles.insert(updates.cleaned.begin(), updates.cleaned.end());
+
+        if (m_lastHighlightTile && updates.cleaned.contains(m_lastHighlightTile->getPosition()))
+            m_lastHighlightTile = nullptr;
+
+        requestUpdateVisibleTiles();
+    }
+}
+
 void MapView::onFadeInFinished()
 {
     requestUpdateVisibleTiles();
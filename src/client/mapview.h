@@ -28,6 +28,8 @@
 #include <framework/luaengine/luaobject.h>
 #include "lightview.h"
 
+struct TileUpdateBatch;
+
 struct AwareRange
 {
     uint8_t left{ 0 };
@@ -87,6 +89,20 @@ public:
         ANTIALIASING_SMOOTH_RETRO
     };
 
+    // draws of the static things of the tiles in a frame: commands replayed as they were
+    // recorded (static), recorded again because the thing changed or its animation phase
+    // ticked (animated), and things that can't be retained and were drawn as usual (live);
+    // the micros are only measured while retained draw profiling is enabled
+    struct RetainedDrawStats
+    {
+        uint64_t staticCommands{ 0 };
+        uint64_t animatedCommands{ 0 };
+        uint64_t liveThings{ 0 };
+        uint64_t staticMicros{ 0 };
+        uint64_t animatedMicros{ 0 };
+        uint64_t liveMicros{ 0 };
+    };
+
     MapView();
     ~MapView() override;
     void draw(const Rect& rect);
@@ -134,6 +150,11 @@ public:
     void setDrawLights(bool enable);
     bool isDrawingLights() const { return m_drawingLight && m_lightView->isDark(); }
 
+    void setRetainedDraw(bool enable) { m_retainedDraw = enable; }
+    bool isRetainedDraw() const { return m_retainedDraw; }
+    void setRetainedDrawProfiling(bool enable) { m_retainedDrawProfiling = enable; }
+    bool isRetainedDrawProfiling() const { return m_retainedDrawProfiling; }
+
     void setLimitVisibleDimension(bool v) { m_limitVisibleDimension = v; }
     bool isLimitedVisibleDimension() const { return m_limitVisibleDimension; }
 
@@ -156,6 +177,11 @@ public:
     std::vector<CreaturePtr> getSpectators(bool multiFloor = false);
     std::vector<CreaturePtr> getSightSpectators(bool multiFloor = false);
 
+    // update count and accumulated time of full and incremental visible tiles updates
+    std::map<std::string, uint64_t> getVisibleTilesStats();
+    // commands, things and time of the retained draws in the last frame
+    std::map<std::string, uint64_t> getRetainedDrawStats();
+
     bool isInRange(const Position& pos, bool ignoreZ = false)
     {
         return getCameraPosition().isInRange(pos, m_posInfo.awareRange.left - 1, m_posInfo.awareRange.right - 2, m_posInfo.awareRange.top - 1, m_posInfo.awareRange.bottom - 2, ignoreZ);
@@ -191,6 +217,7 @@ protected:
     void onGlobalLightChange(const Light& light);
     void onFloorChange(uint8_t floor, uint8_t previousFloor);
     void onTileUpdate(const Position& pos, const ThingPtr& thing, Otc::Operation operation);
+    void onTileUpdates(const TileUpdateBatch& updates);
     void onMapCenterChange(const Position& newPos, const Position& oldPos);
     void onCameraMove(const Point& offset);
     void onFadeInFinished();
@@ -213,9 +240,41 @@ private:
         void clear() { shades.clear(); tiles.clear(); }
     };
 
+    struct VisibleTileCell
+    {
+        TilePtr tile;
+        bool draw{ false };
+        bool shade{ false };
+    };
+
+    // everything besides the camera x/y that the visible tiles depend on
+    struct VisibleTilesState
+    {
+        uint8_t cameraZ;
+        uint8_t firstFloor;
+        uint8_t firstVisibleFloor;
+        uint8_t lastVisibleFloor;
+        FloorViewMode floorViewMode;
+        bool fadeFinished;
+        bool drawingLights;
+        Size drawDimension;
+
+        bool operator==(const VisibleTilesState&) const = default;
+    };
+
+    struct VisibleTilesStats
+    {
+        struct
+        {
+            uint64_t updates{ 0 };
+            uint64_t micros{ 0 };
+        } full, incremental;
+    };
+
     struct FloorData
     {
         MapObject cachedVisibleTiles;
+        std::vector<VisibleTileCell> visibleCells;
         stdext::timer fadingTimers;
     };
 
@@ -312,6 +371,8 @@ private:
     bool m_smooth{ true };
     bool m_follow{ true };
     bool m_drawingLight{ true };
+    bool m_retainedDraw{ true };
+    bool m_retainedDrawProfiling{ false };
 
     bool m_fadeFinish{ false };
     bool m_autoViewMode{ false };
@@ -327,6 +388,11 @@ private:
     std::vector<FloorData> m_floors;
     std::vector<TilePtr> m_foregroundTiles;
 
+    std::optional<VisibleTilesState> m_visibleTilesState;
+    stdext::set<Position, Position::Hasher> m_dirtyVisibleTiles;
+    VisibleTilesStats m_visibleTilesStats;
+    RetainedDrawStats m_retainedDrawStats;
+
     PainterShaderProgramPtr m_shader;
     PainterShaderProgramPtr m_nextShader;
     LightViewPtr m_lightView;
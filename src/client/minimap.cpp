@@ -82,11 +82,15 @@ void MinimapBlock::updateTile(int x, int y, const MinimapTile& tile)
     if (m_tiles[getTileIndex(x, y)].color != tile.color)
         m_mustUpdate = true;
 
+    if (m_tiles[getTileIndex(x, y)] != tile)
+        m_dirty = true;
+
     m_tiles[getTileIndex(x, y)] = tile;
 }
 
 void Minimap::init() {
     m_tileBlocks.resize(g_gameConfig.getMapMaxZ() + 1);
+    m_fileBlocks.resize(g_gameConfig.getMapMaxZ() + 1);
 }
 
 void Minimap::terminate() { clean(); }
@@ -96,6 +100,9 @@ void Minimap::clean()
     std::scoped_lock lock(m_lock);
     for (uint_fast8_t i = 0; i <= g_gameConfig.getMapMaxZ(); ++i)
         m_tileBlocks[i].clear();
+
+    closeOtmmFile();
+    m_pathGraph.clear();
 }
 
 void Minimap::draw(const Rect& screenRect, const Position& mapCenter, float scale, const Color& color)
@@ -205,6 +212,12 @@ void Minimap::updateTile(const Position& pos, const TilePtr& tile)
     if (minimapTile != nulltile) {
         MinimapBlock& block = getBlock(pos);
         const auto& offsetPos = getBlockOffset(Point(pos.x, pos.y));
+
+        const auto& oldTile = block.getTile(pos.x - offsetPos.x, pos.y - offsetPos.y);
+        constexpr uint8_t walkFlags = MinimapTileWasSeen | MinimapTileNotWalkable | MinimapTileNotPathable;
+        if ((oldTile.flags ^ minimapTile.flags) & walkFlags || oldTile.speed != minimapTile.speed)
+            m_pathGraph.invalidate(pos);
+
         block.updateTile(pos.x - offsetPos.x, pos.y - offsetPos.y, minimapTile);
         block.justSaw();
     }
@@ -225,7 +238,10 @@ std::pair<MinimapBlock_ptr, MinimapTile> Minimap::threadGetTile(const Position&
     std::scoped_lock lock(m_lock);
 
     if (pos.z <= g_gameConfig.getMapMaxZ() && hasBlock(pos)) {
-        const auto& block = m_tileBlocks[pos.z][getBlockIndex(pos)];
+        auto& block = m_tileBlocks[pos.z][getBlockIndex(pos)];
+        if (!block)
+            block = loadBlock(pos);
+
         if (block) {
             const auto& offsetPos = getBlockOffset(Point(pos.x, pos.y));
             return std::make_pair(block, block->getTile(pos.x - offsetPos.x, pos.y - offsetPos.y));
@@ -300,9 +316,12 @@ bool Minimap::loadImage(const std::string& fileName, const Position& topLeft, fl
                     tile.color = c;
                     tile.flags = flags;
                     block.mustUpdate();
+                    block.setDirty(true);
                 }
             }
         }
+
+        m_pathGraph.clear();
         return true;
     } catch (const stdext::exception& e) {
         g_logger.error(stdext::format("failed to load OTMM minimap: %s", e.what()));
@@ -315,6 +334,57 @@ void Minimap::saveImage(const std::string&, const Rect&)
     //TODO
 }
 
+MinimapBlock_ptr Minimap::loadBlock(const Position& pos)
+{
+    auto block = std::make_shared<MinimapBlock>();
+
+    auto& fileBlocks = m_fileBlocks[pos.z];
+    const auto it = fileBlocks.find(getBlockIndex(pos));
+    if (it == fileBlocks.end() || !m_otmmFile)
+        return block;
+
+    try {
+        std::vector<uint8_t> compressBuffer(it->second.size);
+        m_otmmFile->seek(it->second.offset);
+        m_otmmFile->read(compressBuffer.data(), compressBuffer.size());
+
+        if (inflateBlock(*block, compressBuffer.data(), compressBuffer.size()))
+            block->justSaw();
+        else
+            g_logger.error(stdext::format("corrupted OTMM block at %d %d %d", pos.x, pos.y, pos.z));
+    } catch (const stdext::exception& e) {
+        g_logger.error(stdext::format("failed to read OTMM block: %s", e.what()));
+    }
+
+    return block;
+}
+
+bool Minimap::inflateBlock(MinimapBlock& block, const uint8_t* data, const uint16_t size)
+{
+    constexpr uint32_t blockSize = MMBLOCK_SIZE * MMBLOCK_SIZE * sizeof(MinimapTile);
+
+    unsigned long destLen = blockSize;
+    const int ret = uncompress(reinterpret_cast<uint8_t*>(&block.getTiles()), &destLen, data, size);
+    if (ret != Z_OK || destLen != blockSize) {
+        block.getTiles().fill({});
+        return false;
+    }
+
+    block.mustUpdate();
+    return true;
+}
+
+void Minimap::closeOtmmFile()
+{
+    for (auto& fileBlocks : m_fileBlocks)
+        fileBlocks.clear();
+
+    if (m_otmmFile) {
+        m_otmmFile->close();
+        m_otmmFile = nullptr;
+    }
+}
+
 bool Minimap::loadOtmm(const std::string& fileName)
 {
     try {
@@ -322,8 +392,6 @@ bool Minimap::loadOtmm(const std::string& fileName)
         if (!fin)
             throw Exception("unable to open file");
 
-        fin->cache();
-
         const uint32_t signature = fin->getU32();
         if (signature != OTMM_SIGNATURE)
             throw Exception("invalid OTMM file");
@@ -334,6 +402,7 @@ bool Minimap::loadOtmm(const std::string& fileName)
 
         switch (version) {
             case 1:
+            case 2:
             {
                 fin->getString(); // description
                 break;
@@ -344,9 +413,51 @@ bool Minimap::loadOtmm(const std::string& fileName)
 
         fin->seek(start);
 
+        std::scoped_lock lock(m_lock);
+
+        // blocks of a previously opened file would point to the wrong offsets
+        if (m_otmmFile) {
+            for (uint_fast8_t z = 0; z <= g_gameConfig.getMapMaxZ(); ++z) {
+                for (const auto& [index, fileBlock] : m_fileBlocks[z]) {
+                    auto& block = m_tileBlocks[z][index];
+                    if (!block)
+                        block = loadBlock(getIndexPosition(index, z));
+                }
+            }
+            closeOtmmFile();
+        }
+
+        if (version >= 2) {
+            // block directory, the tiles are only read when the block is used
+            const uint32_t blockCount = fin->getU32();
+            std::vector<uint8_t> directory(blockCount * OTMM_DIRECTORY_ENTRY_SIZE);
+            if (fin->read(directory.data(), directory.size()) != static_cast<int>(directory.size()))
+                throw Exception("corrupted OTMM block directory");
+
+            for (const uint8_t* entry = directory.data(); entry < directory.data() + directory.size(); entry += OTMM_DIRECTORY_ENTRY_SIZE) {
+                const Position pos(stdext::readULE16(entry), stdext::readULE16(entry + 2), entry[4]);
+
+                FileBlock fileBlock;
+                fileBlock.offset = stdext::readULE32(entry + 5);
+                fileBlock.size = stdext::readULE16(entry + 9);
+
+                if (!pos.isValid() || pos.z >= g_gameConfig.getMapMaxZ() + 1)
+                    continue;
+
+                const uint32_t index = getBlockIndex(pos);
+                m_fileBlocks[pos.z][index] = fileBlock;
+                m_tileBlocks[pos.z].erase(index);
+            }
+
+            m_otmmFile = fin;
+            m_pathGraph.clear();
+            return true;
+        }
+
+        fin->cache();
+
         constexpr uint32_t blockSize = MMBLOCK_SIZE * MMBLOCK_SIZE * sizeof(MinimapTile);
         std::vector<uint8_t> compressBuffer(compressBound(blockSize));
-        std::vector<uint8_t> decompressBuffer(blockSize);
 
         while (true) {
             Position pos;
@@ -358,22 +469,22 @@ bool Minimap::loadOtmm(const std::string& fileName)
             if (!pos.isValid() || pos.z >= g_gameConfig.getMapMaxZ() + 1)
                 break;
 
-            MinimapBlock& block = getBlock(pos);
+            auto& block = m_tileBlocks[pos.z][getBlockIndex(pos)];
+            if (!block)
+                block = std::make_shared<MinimapBlock>();
+
             const uint16_t len = fin->getU16();
             fin->read(compressBuffer.data(), len);
 
-            unsigned long destLen = blockSize;
-            const int ret = uncompress(decompressBuffer.data(), &destLen, compressBuffer.data(), len);
-
-            if (ret != Z_OK || destLen != blockSize)
+            if (!inflateBlock(*block, compressBuffer.data(), len))
                 break;
 
-            memcpy(reinterpret_cast<uint8_t*>(&block.getTiles()), decompressBuffer.data(), blockSize);
-            block.mustUpdate();
-            block.justSaw();
+            block->justSaw();
         }
 
         fin->close();
+
+        m_pathGraph.clear();
         return true;
     } catch (const stdext::exception& e) {
         g_logger.error(stdext::format("failed to load OTMM minimap: %s", e.what()));
@@ -383,8 +494,60 @@ bool Minimap::loadOtmm(const std::string& fileName)
 
 void Minimap::saveOtmm(const std::string& fileName)
 {
+    std::scoped_lock lock(m_lock);
+
+    struct SavedBlock
+    {
+        Position pos;
+        std::vector<uint8_t> data;
+    };
+
+    std::vector<SavedBlock> blocks;
+    std::vector<std::unordered_map<uint32_t, FileBlock>> fileBlocks(m_fileBlocks.size());
+
+    // the new file is written aside, the opened file and its blocks are only
+    // replaced once it is complete
+    const std::string tmpFileName = fileName + ".tmp";
+    bool closed = false;
+    bool renamed = false;
+
     try {
-        const FileStreamPtr fin = g_resources.createFile(fileName);
+        constexpr uint32_t blockSize = MMBLOCK_SIZE * MMBLOCK_SIZE * sizeof(MinimapTile);
+        constexpr uint32_t COMPRESS_LEVEL = 3;
+
+        // only the blocks changed since they were read are compressed again,
+        // the others are copied as they are in the opened file.
+        for (uint_fast8_t z = 0; z <= g_gameConfig.getMapMaxZ(); ++z) {
+            for (const auto& [index, block] : m_tileBlocks[z]) {
+                if (!block->wasSeen() || (!block->isDirty() && m_otmmFile && m_fileBlocks[z].contains(index)))
+                    continue;
+
+                auto& saved = blocks.emplace_back();
+                saved.pos = getIndexPosition(index, z);
+                saved.data.resize(compressBound(blockSize));
+
+                unsigned long len = saved.data.size();
+                compress2(saved.data.data(), &len, reinterpret_cast<uint8_t*>(&block->getTiles()), blockSize, COMPRESS_LEVEL);
+                saved.data.resize(len);
+            }
+
+            if (!m_otmmFile)
+                continue;
+
+            for (const auto& [index, fileBlock] : m_fileBlocks[z]) {
+                const auto it = m_tileBlocks[z].find(index);
+                if (it != m_tileBlocks[z].end() && it->second->isDirty() && it->second->wasSeen())
+                    continue;
+
+                auto& saved = blocks.emplace_back();
+                saved.pos = getIndexPosition(index, z);
+                saved.data.resize(fileBlock.size);
+                m_otmmFile->seek(fileBlock.offset);
+                m_otmmFile->read(saved.data.data(), fileBlock.size);
+            }
+        }
+
+        const FileStreamPtr fin = g_resources.createFile(tmpFileName);
         fin->cache();
 
         //TODO: compression flag with zlib
@@ -396,8 +559,8 @@ void Minimap::saveOtmm(const std::string& fileName)
         fin->addU16(OTMM_VERSION);
         fin->addU32(flags);
 
-        // version 1 header
-        fin->addString("OTMM 1.0"); // description
+        // version 2 header
+        fin->addString("OTMM 2.0"); // description
 
         // go back and rewrite where the map data starts
         const uint32_t start = fin->tell();
@@ -405,37 +568,72 @@ void Minimap::saveOtmm(const std::string& fileName)
         fin->addU16(start);
         fin->seek(start);
 
-        constexpr uint32_t blockSize = MMBLOCK_SIZE * MMBLOCK_SIZE * sizeof(MinimapTile);
-        constexpr uint32_t COMPRESS_LEVEL = 3;
-        std::vector<uint8_t> compressBuffer(compressBound(blockSize));
-
-        for (uint_fast8_t z = 0; z <= g_gameConfig.getMapMaxZ(); ++z) {
-            for (const auto& [index, block] : m_tileBlocks[z]) {
-                if (!(*block).wasSeen())
-                    continue;
+        // block directory
+        uint32_t offset = start + 4 + blocks.size() * OTMM_DIRECTORY_ENTRY_SIZE;
 
-                const auto& pos = getIndexPosition(index, z);
-                fin->addU16(pos.x);
-                fin->addU16(pos.y);
-                fin->addU8(pos.z);
+        fin->addU32(blocks.size());
+        for (const auto& saved : blocks) {
+            fin->addU16(saved.pos.x);
+            fin->addU16(saved.pos.y);
+            fin->addU8(saved.pos.z);
+            fin->addU32(offset);
+            fin->addU16(saved.data.size());
 
-                unsigned long len = blockSize;
-                compress2(compressBuffer.data(), &len, (uint8_t*)&(*block).getTiles(), blockSize, COMPRESS_LEVEL);
-                fin->addU16(len);
-                fin->write(compressBuffer.data(), len);
-            }
+            fileBlocks[saved.pos.z][getBlockIndex(saved.pos)] = { offset, static_cast<uint16_t>(saved.data.size()) };
+            offset += saved.data.size();
         }
 
-        // end of file
-        const Position invalidPos;
-        fin->addU16(invalidPos.x);
-        fin->addU16(invalidPos.y);
-        fin->addU8(invalidPos.z);
+        for (const auto& saved : blocks)
+            fin->write(saved.data.data(), saved.data.size());
 
         fin->flush();
-
         fin->close();
+
+        // the opened file may be the one being replaced
+        if (m_otmmFile) {
+            m_otmmFile->close();
+            closed = true;
+        }
+
+        renamed = g_resources.renameFile(tmpFileName, fileName);
+        if (!renamed)
+            g_logger.error(stdext::format("failed to save OTMM minimap: unable to replace '%s'", fileName));
     } catch (const stdext::exception& e) {
         g_logger.error(stdext::format("failed to save OTMM minimap: %s", e.what()));
     }
-}
\ No newline at end of file
+
+    if (!renamed) {
+        g_resources.deleteFile(tmpFileName);
+
+        // the opened file was left untouched
+        if (!closed)
+            return;
+    } else {
+        m_fileBlocks = std::move(fileBlocks);
+        for (const auto& tileBlocks : m_tileBlocks) {
+            for (const auto& [index, block] : tileBlocks)
+                block->setDirty(false);
+        }
+    }
+
+    // keep reading the blocks not used yet from the file, the saved data
+    // holds all of them in case it can't be opened again
+    try {
+        m_otmmFile = g_resources.openFile(fileName);
+    } catch (const stdext::exception& e) {
+        g_logger.error(stdext::format("failed to reopen OTMM minimap: %s", e.what()));
+
+        for (const auto& saved : blocks) {
+            auto& block = m_tileBlocks[saved.pos.z][getBlockIndex(saved.pos)];
+            if (block)
+                continue;
+
+            block = std::make_shared<MinimapBlock>();
+            if (inflateBlock(*block, saved.data.data(), saved.data.size()))
+                block->justSaw();
+        }
+
+        m_otmmFile = nullptr;
+        closeOtmmFile();
+    }
+}
@@ -22,13 +22,16 @@
 
 #pragma once
 
+#include <framework/core/declarations.h>
 #include <framework/graphics/declarations.h>
 #include "declarations.h"
 #include "gameconfig.h"
+#include "pathfinding.h"
 
 constexpr uint8_t MMBLOCK_SIZE = 64;
-constexpr uint8_t OTMM_VERSION = 1;
+constexpr uint8_t OTMM_VERSION = 2;
 constexpr uint32_t OTMM_SIGNATURE = 0x4D4d544F;
+constexpr uint32_t OTMM_DIRECTORY_ENTRY_SIZE = 2 + 2 + 1 + 4 + 2; // x, y, z, offset, size
 
 enum MinimapTileFlags
 {
@@ -64,6 +67,8 @@ public:
     void mustUpdate() { m_mustUpdate = true; }
     void justSaw() { m_wasSeen = true; }
     bool wasSeen() const { return m_wasSeen; }
+    void setDirty(bool v) { m_dirty = v; }
+    bool isDirty() const { return m_dirty; }
 private:
     TexturePtr m_texture;
     ImagePtr m_image;
@@ -74,6 +79,7 @@ private:
 
     bool m_mustUpdate{ true };
     bool m_wasSeen{ false };
+    bool m_dirty{ false }; // changed since it was read from the OTMM file
 };
 
 #pragma pack(pop)
@@ -97,6 +103,8 @@ public:
     const MinimapTile& getTile(const Position& pos);
     std::pair<MinimapBlock_ptr, MinimapTile> threadGetTile(const Position& pos);
 
+    PathFindResult_ptr findPath(const Position& start, const Position& goal) { return m_pathGraph.findPath(start, goal); }
+
     bool loadImage(const std::string& fileName, const Position& topLeft, float colorFactor);
     void saveImage(const std::string& fileName, const Rect& mapRect);
     bool loadOtmm(const std::string& fileName);
@@ -104,15 +112,24 @@ public:
 
 private:
     Rect calcMapRect(const Rect& screenRect, const Position& mapCenter, float scale) const;
-    bool hasBlock(const Position& pos) { return m_tileBlocks[pos.z].contains(getBlockIndex(pos)); }
+    struct FileBlock
+    {
+        uint32_t offset;
+        uint16_t size;
+    };
+
+    bool hasBlock(const Position& pos) { return m_tileBlocks[pos.z].contains(getBlockIndex(pos)) || m_fileBlocks[pos.z].contains(getBlockIndex(pos)); }
     MinimapBlock& getBlock(const Position& pos)
     {
         std::scoped_lock lock(m_lock);
         auto& ptr = m_tileBlocks[pos.z][getBlockIndex(pos)];
         if (!ptr)
-            ptr = std::make_shared<MinimapBlock>();
+            ptr = loadBlock(pos);
         return *ptr;
     }
+    MinimapBlock_ptr loadBlock(const Position& pos);
+    static bool inflateBlock(MinimapBlock& block, const uint8_t* data, uint16_t size);
+    void closeOtmmFile();
     Point getBlockOffset(const Point& pos)
     {
         return {
@@ -130,6 +147,12 @@ private:
     uint32_t getBlockIndex(const Position& pos) { return ((pos.y / MMBLOCK_SIZE) * (65536 / MMBLOCK_SIZE)) + (pos.x / MMBLOCK_SIZE); }
     std::vector<std::unordered_map<uint32_t, MinimapBlock_ptr>> m_tileBlocks;
     std::mutex m_lock;
+
+    // blocks of the opened OTMM file, inflated on first use
+    std::vector<std::unordered_map<uint32_t, FileBlock>> m_fileBlocks;
+    FileStreamPtr m_otmmFile;
+
+    MinimapPathGraph m_pathGraph;
 };
 
 extern Minimap g_minimap;
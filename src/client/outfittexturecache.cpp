@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "outfittexturecache.h"
+#include "gameconfig.h"
+#include "outfit.h"
+#include "thingtype.h"
+#include "thingtypemanager.h"
+
+#include <framework/graphics/drawpoolmanager.h>
+#include <framework/graphics/image.h>
+#include <framework/graphics/texture.h>
+
+namespace
+{
+    // same result as drawing the mask layers with CompositionMode::MULTIPLY:
+    // pixels under a mask color get multiplied by the matching outfit color.
+    // Kept branchless so the compiler can vectorize it.
+    void applyOutfitMask(uint8_t* pixels, const uint8_t* mask, const int count, const uint32_t(&maskColors)[4], const uint8_t(&outfitColors)[4][3])
+    {
+        for (int i = 0; i < count; ++i) {
+            uint32_t maskPixel;
+            std::memcpy(&maskPixel, mask + i * 4, sizeof(maskPixel));
+
+            uint32_t r = 255, g = 255, b = 255;
+            for (int c = 0; c < 4; ++c) {
+                const bool masked = maskPixel == maskColors[c];
+                r = masked ? outfitColors[c][0] : r;
+                g = masked ? outfitColors[c][1] : g;
+                b = masked ? outfitColors[c][2] : b;
+            }
+
+            uint8_t* p = pixels + i * 4;
+            p[0] = static_cast<uint8_t>((p[0] * r + 127) / 255);
+            p[1] = static_cast<uint8_t>((p[1] * g + 127) / 255);
+            p[2] = static_cast<uint8_t>((p[2] * b + 127) / 255);
+        }
+    }
+
+    // addons are drawn on top of the outfit with the normal composition
+    void blendOver(uint8_t* dst, const uint8_t* src, const int count)
+    {
+        for (int i = 0; i < count; ++i, dst += 4, src += 4) {
+            const uint32_t srcAlpha = src[3];
+            if (srcAlpha == 0)
+                continue;
+
+            if (srcAlpha == 255) {
+                std::memcpy(dst, src, 4);
+                continue;
+            }
+
+            const uint32_t dstAlpha = dst[3] * (255 - srcAlpha);
+            const uint32_t outAlpha = srcAlpha * 255 + dstAlpha;
+            for (int c = 0; c < 3; ++c)
+                dst[c] = static_cast<uint8_t>((src[c] * srcAlpha * 255 + dst[c] * dstAlpha) / outAlpha);
+            dst[3] = static_cast<uint8_t>((outAlpha + 127) / 255);
+        }
+    }
+}
+
+bool OutfitTextureCache::draw(const Point& dest, ThingType* type, const Outfit& outfit, int xPattern, int zPattern, int animationPhase, const Color& color)
+{
+    // translucent outfits and framebuffer shaders depend on each layer being drawn separately
+    if (type->getOpacity() < 1.0f || g_drawPool.shaderNeedFramebuffer())
+        return false;
+
+    const Key key{ type->getId(), outfit.getHead(), outfit.getBody(), outfit.getLegs(), outfit.getFeet(),
+        static_cast<uint8_t>(outfit.getAddons()), xPattern, zPattern, animationPhase };
+
+    size_t hash = 0;
+    stdext::hash_union(hash, key.id);
+    stdext::hash_union(hash, key.head | key.body << 8 | key.legs << 16 | key.feet << 24);
+    stdext::hash_union(hash, key.addons);
+    stdext::hash_union(hash, key.xPattern);
+    stdext::hash_union(hash, key.zPattern);
+    stdext::hash_union(hash, key.animationPhase);
+
+    TexturePtr texture;
+    Rect textureRect;
+    {
+        std::scoped_lock l(m_mutex);
+
+        if (const auto it = m_index.find(hash); it != m_index.end()) {
+            if (it->second->key == key) {
+                m_cache.splice(m_cache.begin(), m_cache, it->second);
+                texture = it->second->texture;
+                textureRect = it->second->textureRect;
+                ++m_hits;
+            } else {
+                // hash collision, the new frame takes its place
+                release(*it->second);
+                m_cache.erase(it->second);
+                m_index.erase(it);
+            }
+        }
+
+        if (!texture) {
+            // sprites are only read back once the outfit texture is loaded,
+            // until then the layers are drawn (or skipped) as usual.
+            if (!type->getTexture(animationPhase))
+                return false;
+
+            ++m_misses;
+
+            const auto& image = compose(type, outfit, xPattern, zPattern, animationPhase);
+            if (!image)
+                return false;
+
+            Entry entry{ hash, key };
+            if (g_things.isTextureAtlasEnabled())
+                entry.texture = g_things.getTextureAtlas().add(image, entry.atlasRect);
+
+            if (entry.texture)
+                entry.textureRect = entry.atlasRect;
+            else {
+                entry.texture = std::make_shared<Texture>(image, true, false);
+                entry.textureRect = Rect(Point(0), image->getSize());
+            }
+
+            texture = entry.texture;
+            textureRect = entry.textureRect;
+
+            m_cache.emplace_front(std::move(entry));
+            m_index[hash] = m_cache.begin();
+
+            if (m_cache.size() > CACHE_SIZE) {
+                release(m_cache.back());
+                m_index.erase(m_cache.back().hash);
+                m_cache.pop_back();
+            }
+        }
+    }
+
+    const auto& offset = type->getDisplacement() + (type->getSize().toPoint() - Point(1)) * g_gameConfig.getSpriteSize();
+    g_drawPool.addTexturedRect(Rect(dest - offset * g_drawPool.getScaleFactor(), textureRect.size() * g_drawPool.getScaleFactor()), texture, textureRect, color);
+    return true;
+}
+
+ImagePtr OutfitTextureCache::compose(ThingType* type, const Outfit& outfit, int xPattern, int zPattern, int animationPhase)
+{
+    static const uint32_t maskColors[] = { Color::yellow.rgba(), Color::red.rgba(), Color::green.rgba(), Color::blue.rgba() };
+
+    uint8_t outfitColors[4][3];
+    const Color colors[] = { outfit.getHeadColor(), outfit.getBodyColor(), outfit.getLegsColor(), outfit.getFeetColor() };
+    for (int c = 0; c < 4; ++c) {
+        outfitColors[c][0] = colors[c].r();
+        outfitColors[c][1] = colors[c].g();
+        outfitColors[c][2] = colors[c].b();
+    }
+
+    ImagePtr frame;
+
+    // yPattern => creature addon
+    for (int yPattern = 0; yPattern < type->getNumPatternY(); ++yPattern) {
+        if (yPattern > 0 && !(outfit.getAddons() & (1 << (yPattern - 1))))
+            continue;
+
+        const auto& image = type->getFrameImage(0, xPattern, yPattern, zPattern, animationPhase);
+        if (!image)
+            return nullptr;
+
+        if (type->getLayers() > 1) {
+            if (const auto& mask = type->getFrameImage(1, xPattern, yPattern, zPattern, animationPhase))
+                applyOutfitMask(image->getPixelData(), mask->getPixelData(), image->getPixelCount(), maskColors, outfitColors);
+        }
+
+        if (frame)
+            blendOver(frame->getPixelData(), image->getPixelData(), frame->getPixelCount());
+        else
+            frame = image;
+    }
+
+    return frame;
+}
+
+void OutfitTextureCache::release(const Entry& entry)
+{
+    if (entry.atlasRect.isValid())
+        g_things.getTextureAtlas().remove(entry.texture, entry.atlasRect);
+}
+
+void OutfitTextureCache::clear()
+{
+    std::scoped_lock l(m_mutex);
+
+    for (const auto& entry : m_cache)
+        release(entry);
+
+    m_cache.clear();
+    m_index.clear();
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "declarations.h"
+#include <framework/graphics/declarations.h>
+
+class Outfit;
+
+// Keeps creature frames with the outfit colors and addons already applied, so
+// a colored outfit is drawn with a single textured rect instead of one base
+// pass plus four multiply passes for each addon. Frames are packed in the
+// things texture atlas when possible; the least recently used are evicted.
+class OutfitTextureCache
+{
+public:
+    // returns false when the frame can't be drawn from the cache,
+    // in that case the caller must draw the outfit layers by itself.
+    bool draw(const Point& dest, ThingType* type, const Outfit& outfit, int xPattern, int zPattern, int animationPhase, const Color& color);
+    void clear();
+
+    uint32_t getHits() const { return m_hits; }
+    uint32_t getMisses() const { return m_misses; }
+
+private:
+    static constexpr size_t CACHE_SIZE = 512;
+
+    struct Key
+    {
+        uint16_t id;
+        uint8_t head, body, legs, feet, addons;
+        int xPattern, zPattern, animationPhase;
+
+        bool operator==(const Key&) const = default;
+    };
+
+    struct Entry
+    {
+        size_t hash;
+        Key key;
+        TexturePtr texture;
+        Rect textureRect;
+        Rect atlasRect; // valid when texture is a texture atlas page
+    };
+
+    ImagePtr compose(ThingType* type, const Outfit& outfit, int xPattern, int zPattern, int animationPhase);
+    void release(const Entry& entry);
+
+    std::list<Entry> m_cache;
+    stdext::map<size_t, std::list<Entry>::iterator> m_index;
+    std::mutex m_mutex;
+
+    std::atomic_uint32_t m_hits{ 0 };
+    std::atomic_uint32_t m_misses{ 0 };
+};
@@ -0,0 +1,525 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "pathfinding.h"
+#include "minimap.h"
+
+#include <bit>
+
+PathFindingArena& PathFindingArena::get()
+{
+    thread_local PathFindingArena arena;
+    return arena;
+}
+
+void PathFindingArena::reset()
+{
+    // bumping the generation empties every slot without touching the table
+    if (++m_generation == 0) {
+        m_slots.assign(m_slots.size(), {});
+        m_generation = 1;
+    }
+
+    m_visitedCount = 0;
+    m_usedNodes = 0;
+    m_heap.clear();
+}
+
+PathFindingArena::Slot& PathFindingArena::findSlot(const uint64_t key)
+{
+    const size_t mask = m_slots.size() - 1;
+    for (size_t i = (key * 0x9E3779B97F4A7C15ull) >> m_shift;; i = (i + 1) & mask) {
+        auto& slot = m_slots[i];
+        if (slot.generation != m_generation || slot.key == key)
+            return slot;
+    }
+}
+
+void PathFindingArena::grow()
+{
+    auto slots = std::move(m_slots);
+
+    m_slots.resize(std::max<size_t>(slots.size() * 2, 1024));
+    m_shift = 64 - std::countr_zero(m_slots.size());
+
+    for (const auto& slot : slots) {
+        if (slot.generation == m_generation)
+            findSlot(slot.key) = slot;
+    }
+}
+
+Node*& PathFindingArena::visit(const Position& pos, bool& inserted)
+{
+    // keep the load factor under 50%, so the probing stays short
+    if ((m_visitedCount + 1) * 2 > m_slots.size())
+        grow();
+
+    const uint64_t key = packPosition(pos);
+
+    auto& slot = findSlot(key);
+    inserted = slot.generation != m_generation;
+    if (inserted) {
+        slot.key = key;
+        slot.generation = m_generation;
+        slot.node = nullptr;
+        ++m_visitedCount;
+    }
+
+    return slot.node;
+}
+
+Node* PathFindingArena::createNode(const Node& node)
+{
+    if (m_usedNodes == m_chunks.size() * NODES_PER_CHUNK)
+        m_chunks.emplace_back(std::make_unique<Node[]>(NODES_PER_CHUNK));
+
+    auto* newNode = &m_chunks[m_usedNodes / NODES_PER_CHUNK][m_usedNodes % NODES_PER_CHUNK];
+    *newNode = node;
+    newNode->heapIndex = -1;
+    ++m_usedNodes;
+
+    return newNode;
+}
+
+void PathFindingArena::push(Node* node)
+{
+    if (node->heapIndex < 0) {
+        m_heap.emplace_back(node);
+        node->heapIndex = m_heap.size() - 1;
+    }
+
+    siftUp(node->heapIndex);
+}
+
+Node* PathFindingArena::pop()
+{
+    auto* node = m_heap.front();
+    node->heapIndex = -1;
+
+    auto* last = m_heap.back();
+    m_heap.pop_back();
+
+    if (!m_heap.empty()) {
+        place(last, 0);
+        siftDown(0);
+    }
+
+    return node;
+}
+
+void PathFindingArena::siftUp(size_t index)
+{
+    auto* node = m_heap[index];
+    while (index > 0) {
+        const size_t parent = (index - 1) / 2;
+        if (m_heap[parent]->totalCost <= node->totalCost)
+            break;
+
+        place(m_heap[parent], index);
+        index = parent;
+    }
+
+    place(node, index);
+}
+
+void PathFindingArena::siftDown(size_t index)
+{
+    auto* node = m_heap[index];
+    const size_t size = m_heap.size();
+    while (true) {
+        size_t child = index * 2 + 1;
+        if (child >= size)
+            break;
+
+        if (child + 1 < size && m_heap[child + 1]->totalCost < m_heap[child]->totalCost)
+            ++child;
+
+        if (node->totalCost <= m_heap[child]->totalCost)
+            break;
+
+        place(m_heap[child], index);
+        index = child;
+    }
+
+    place(node, index);
+}
+
+static_assert(MinimapPathGraph::CLUSTER_SIZE == MMBLOCK_SIZE, "clusters must match the minimap blocks");
+
+namespace
+{
+    constexpr int CLUSTER_TILES = MinimapPathGraph::CLUSTER_SIZE * MinimapPathGraph::CLUSTER_SIZE;
+    constexpr int MAX_EXPANDED_NODES = 50000;
+    constexpr float UNREACHABLE = std::numeric_limits<float>::max();
+
+    uint8_t getWalkSpeed(const MinimapTile& tile)
+    {
+        if (!tile.hasFlag(MinimapTileWasSeen) || tile.hasFlag(MinimapTileNotWalkable) || tile.hasFlag(MinimapTileNotPathable))
+            return 0;
+
+        return std::max<uint8_t>(tile.speed, 1);
+    }
+
+    struct ClusterSearch
+    {
+        std::array<float, CLUSTER_TILES> costs;
+        std::array<int16_t, CLUSTER_TILES> prev;
+        std::vector<std::pair<float, uint16_t>> heap;
+    };
+
+    ClusterSearch& getClusterSearch()
+    {
+        thread_local ClusterSearch search;
+        return search;
+    }
+
+    // dijkstra restricted to a single cluster, with the same costs as Map::findPath:
+    // stepping into a tile costs its ground speed / 100, three times that in diagonal.
+    // Stops once `to` is reached, or explores the whole cluster when it is -1.
+    void searchCluster(const std::array<uint8_t, CLUSTER_TILES>& speeds, const int from, const int to, ClusterSearch& search)
+    {
+        constexpr int size = MinimapPathGraph::CLUSTER_SIZE;
+
+        search.costs.fill(UNREACHABLE);
+        search.prev.fill(-1);
+        search.heap.clear();
+
+        search.costs[from] = 0;
+        search.heap.emplace_back(0.f, from);
+
+        while (!search.heap.empty()) {
+            std::pop_heap(search.heap.begin(), search.heap.end(), std::greater());
+            const auto [cost, index] = search.heap.back();
+            search.heap.pop_back();
+
+            if (cost > search.costs[index])
+                continue;
+
+            if (index == to)
+                break;
+
+            const int x = index % size;
+            const int y = index / size;
+            for (int i = -1; i <= 1; ++i) {
+                for (int j = -1; j <= 1; ++j) {
+                    if (i == 0 && j == 0)
+                        continue;
+
+                    const int nx = x + i;
+                    const int ny = y + j;
+                    if (nx < 0 || ny < 0 || nx >= size || ny >= size)
+                        continue;
+
+                    const int neighbor = ny * size + nx;
+                    const uint8_t speed = speeds[neighbor];
+                    if (!speed)
+                        continue;
+
+                    const float neighborCost = cost + (speed * (i == 0 || j == 0 ? 1.f : 3.f)) / 10.f;
+                    if (neighborCost >= search.costs[neighbor])
+                        continue;
+
+                    search.costs[neighbor] = neighborCost;
+                    search.prev[neighbor] = index;
+                    search.heap.emplace_back(neighborCost, neighbor);
+                    std::push_heap(search.heap.begin(), search.heap.end(), std::greater());
+                }
+            }
+        }
+    }
+}
+
+const MinimapPathGraph::Entrance* MinimapPathGraph::Cluster::findEntrance(const uint16_t index) const
+{
+    for (const auto& entrance : entrances) {
+        if (entrance.index == index)
+            return &entrance;
+    }
+    return nullptr;
+}
+
+void MinimapPathGraph::invalidate(const Position& pos)
+{
+    std::scoped_lock l(m_invalidationMutex);
+    m_invalidated.emplace(getClusterKey(pos));
+
+    // entrances on a border are shared with the neighbour cluster
+    const int x = pos.x % CLUSTER_SIZE;
+    const int y = pos.y % CLUSTER_SIZE;
+    if (x == 0 && pos.x > 0)
+        m_invalidated.emplace(getClusterKey(pos.translated(-1, 0)));
+    else if (x == CLUSTER_SIZE - 1)
+        m_invalidated.emplace(getClusterKey(pos.translated(1, 0)));
+
+    if (y == 0 && pos.y > 0)
+        m_invalidated.emplace(getClusterKey(pos.translated(0, -1)));
+    else if (y == CLUSTER_SIZE - 1)
+        m_invalidated.emplace(getClusterKey(pos.translated(0, 1)));
+}
+
+void MinimapPathGraph::clear()
+{
+    std::scoped_lock l(m_invalidationMutex);
+    m_invalidated.clear();
+    m_cleared = true;
+}
+
+void MinimapPathGraph::applyInvalidations()
+{
+    std::scoped_lock l(m_invalidationMutex);
+    if (m_cleared) {
+        m_clusters.clear();
+        m_cleared = false;
+    }
+
+    for (const uint64_t key : m_invalidated)
+        m_clusters.erase(key);
+    m_invalidated.clear();
+}
+
+const MinimapPathGraph::Cluster& MinimapPathGraph::getCluster(const Position& pos)
+{
+    auto& cluster = m_clusters[getClusterKey(pos)];
+    if (!cluster)
+        cluster = buildCluster(pos);
+    return *cluster;
+}
+
+std::unique_ptr<MinimapPathGraph::Cluster> MinimapPathGraph::buildCluster(const Position& pos)
+{
+    auto cluster = std::make_unique<Cluster>();
+    cluster->origin = Position(pos.x - pos.x % CLUSTER_SIZE, pos.y - pos.y % CLUSTER_SIZE, pos.z);
+    cluster->speeds.fill(0);
+
+    if (const auto& block = g_minimap.threadGetTile(cluster->origin).first) {
+        const auto& tiles = block->getTiles();
+        for (int i = 0; i < CLUSTER_TILES; ++i)
+            cluster->speeds[i] = getWalkSpeed(tiles[i]);
+    }
+
+    // place an entrance in the middle of each walkable run along the borders
+    static constexpr std::array<std::pair<int, int>, 4> sides{ { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } } };
+    for (const auto& [dx, dy] : sides) {
+        const Position neighborOrigin = cluster->origin.translated(dx * CLUSTER_SIZE, dy * CLUSTER_SIZE);
+        if (neighborOrigin.x < 0 || neighborOrigin.y < 0)
+            continue;
+
+        const auto& neighborBlock = g_minimap.threadGetTile(neighborOrigin).first;
+        if (!neighborBlock)
+            continue;
+
+        const auto& neighborTiles = neighborBlock->getTiles();
+
+        int runStart = -1;
+        for (int i = 0; i <= CLUSTER_SIZE; ++i) {
+            bool open = false;
+            uint16_t index = 0, neighborIndex = 0;
+            if (i < CLUSTER_SIZE) {
+                const int x = dx == 0 ? i : (dx < 0 ? 0 : CLUSTER_SIZE - 1);
+                const int y = dy == 0 ? i : (dy < 0 ? 0 : CLUSTER_SIZE - 1);
+                index = y * CLUSTER_SIZE + x;
+                neighborIndex = ((y + dy + CLUSTER_SIZE) % CLUSTER_SIZE) * CLUSTER_SIZE + (x + dx + CLUSTER_SIZE) % CLUSTER_SIZE;
+                open = cluster->speeds[index] && getWalkSpeed(neighborTiles[neighborIndex]);
+            }
+
+            if (open) {
+                if (runStart < 0)
+                    runStart = i;
+                continue;
+            }
+
+            if (runStart < 0)
+                continue;
+
+            const int middle = runStart + (i - 1 - runStart) / 2;
+            runStart = -1;
+
+            const int x = dx == 0 ? middle : (dx < 0 ? 0 : CLUSTER_SIZE - 1);
+            const int y = dy == 0 ? middle : (dy < 0 ? 0 : CLUSTER_SIZE - 1);
+            const Position outside = cluster->origin.translated(x + dx, y + dy);
+
+            auto& entrance = cluster->entrances.emplace_back();
+            entrance.index = y * CLUSTER_SIZE + x;
+            entrance.outside = outside;
+            entrance.outsideCost = getWalkSpeed(neighborTiles[getTileIndex(outside)]) / 10.f;
+        }
+    }
+
+    // link the entrances with the cost of the shortest path between them
+    auto& search = getClusterSearch();
+    for (auto& entrance : cluster->entrances) {
+        searchCluster(cluster->speeds, entrance.index, -1, search);
+        for (size_t i = 0; i < cluster->entrances.size(); ++i) {
+            const auto& other = cluster->entrances[i];
+            if (&other != &entrance && search.costs[other.index] != UNREACHABLE)
+                entrance.edges.emplace_back(i, search.costs[other.index]);
+        }
+    }
+
+    return cluster;
+}
+
+PathFindResult_ptr MinimapPathGraph::findPath(const Position& start, const Position& goal)
+{
+    auto ret = std::make_shared<PathFindResult>();
+    ret->start = start;
+    ret->destination = goal;
+
+    if (start == goal) {
+        ret->status = Otc::PathFindResultSamePosition;
+        return ret;
+    }
+
+    if (start.z != goal.z) {
+        ret->status = Otc::PathFindResultImpossible;
+        return ret;
+    }
+
+    if (start.x < 0 || start.y < 0 || goal.x < 0 || goal.y < 0)
+        return ret;
+
+    std::scoped_lock l(m_mutex);
+    applyInvalidations();
+
+    const auto& startCluster = getCluster(start);
+    const auto& goalCluster = getCluster(goal);
+
+    const uint16_t goalIndex = getTileIndex(goal);
+    if (!goalCluster.speeds[goalIndex])
+        return ret;
+
+    auto& search = getClusterSearch();
+
+    // costs from the start to the entrances of its cluster, and to the goal when it is in the same one
+    searchCluster(startCluster.speeds, getTileIndex(start), -1, search);
+    std::vector<float> startCosts;
+    startCosts.reserve(startCluster.entrances.size());
+    for (const auto& entrance : startCluster.entrances)
+        startCosts.emplace_back(search.costs[entrance.index]);
+    const float directCost = &startCluster == &goalCluster ? search.costs[goalIndex] : UNREACHABLE;
+
+    // costs from the entrances of the goal cluster to the goal
+    searchCluster(goalCluster.speeds, goalIndex, -1, search);
+    std::vector<float> goalCosts;
+    goalCosts.reserve(goalCluster.entrances.size());
+    for (const auto& entrance : goalCluster.entrances)
+        goalCosts.emplace_back(search.costs[entrance.index]);
+
+    auto& arena = PathFindingArena::get();
+    arena.reset();
+
+    const auto& relax = [&](Node* from, const Position& pos, const float cost) {
+        bool inserted;
+        auto*& node = arena.visit(pos, inserted);
+        if (inserted)
+            node = arena.createNode({ UNREACHABLE, UNREACHABLE, pos, nullptr, 0, 0 });
+
+        const float newCost = from->cost + cost;
+        if (newCost >= node->cost)
+            return;
+
+        node->cost = newCost;
+        node->totalCost = newCost + std::max<int>(std::abs(goal.x - pos.x), std::abs(goal.y - pos.y));
+        node->prev = from;
+        arena.push(node);
+    };
+
+    bool inserted;
+    auto* startNode = arena.visit(start, inserted) = arena.createNode({ 0, 0, start, nullptr, 0, 0 });
+    arena.push(startNode);
+
+    Node* goalNode = nullptr;
+    while (!arena.empty()) {
+        Node* node = arena.pop();
+        if (node->pos == goal) {
+            goalNode = node;
+            break;
+        }
+
+        if (++ret->complexity > MAX_EXPANDED_NODES) {
+            ret->status = Otc::PathFindResultTooFar;
+            break;
+        }
+
+        if (node == startNode) {
+            for (size_t i = 0; i < startCosts.size(); ++i) {
+                if (startCosts[i] != UNREACHABLE)
+                    relax(node, startCluster.getPosition(startCluster.entrances[i].index), startCosts[i]);
+            }
+
+            if (directCost != UNREACHABLE)
+                relax(node, goal, directCost);
+        }
+
+        const auto& cluster = getCluster(node->pos);
+        const auto* entrance = cluster.findEntrance(getTileIndex(node->pos));
+        if (!entrance)
+            continue;
+
+        for (const auto& [other, cost] : entrance->edges)
+            relax(node, cluster.getPosition(cluster.entrances[other].index), cost);
+
+        relax(node, entrance->outside, entrance->outsideCost);
+
+        if (&cluster == &goalCluster) {
+            const float cost = goalCosts[entrance - cluster.entrances.data()];
+            if (cost != UNREACHABLE)
+                relax(node, goal, cost);
+        }
+    }
+
+    if (!goalNode)
+        return ret;
+
+    std::vector<Position> waypoints;
+    for (const Node* node = goalNode; node; node = node->prev)
+        waypoints.emplace_back(node->pos);
+    std::reverse(waypoints.begin(), waypoints.end());
+
+    // expand every hop inside a cluster into single steps
+    std::vector<Otc::Direction> steps;
+    for (size_t i = 1; i < waypoints.size(); ++i) {
+        const auto& from = waypoints[i - 1];
+        const auto& to = waypoints[i];
+
+        if (getClusterKey(from) != getClusterKey(to)) {
+            ret->path.emplace_back(from.getDirectionFromPosition(to));
+            continue;
+        }
+
+        const auto& cluster = getCluster(from);
+        const int toIndex = getTileIndex(to);
+        searchCluster(cluster.speeds, getTileIndex(from), toIndex, search);
+        if (search.costs[toIndex] == UNREACHABLE) {
+            ret->path.clear();
+            return ret;
+        }
+
+        steps.clear();
+        for (int index = toIndex; search.prev[index] >= 0; index = search.prev[index])
+            steps.emplace_back(cluster.getPosition(search.prev[index]).getDirectionFromPosition(cluster.getPosition(index)));
+        ret->path.insert(ret->path.end(), steps.rbegin(), steps.rend());
+    }
+
+    ret->status = Otc::PathFindResultOk;
+    return ret;
+}
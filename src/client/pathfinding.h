@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <framework/global.h>
+#include "position.h"
+
+struct PathFindResult
+{
+    Otc::PathFindResult status = Otc::PathFindResultNoWay;
+    std::vector<Otc::Direction> path;
+    int complexity = 0;
+    Position start;
+    Position destination;
+};
+using PathFindResult_ptr = std::shared_ptr<PathFindResult>;
+
+struct Node
+{
+    float cost;
+    float totalCost;
+    Position pos;
+    Node* prev;
+    int distance;
+    int unseen;
+    int heapIndex{ -1 }; // position in the open list, -1 when not queued
+};
+
+// Scratch memory shared by the map path finders.
+// Each thread owns an instance that is reset, not freed, between searches,
+// so once warmed up a search does not allocate.
+class PathFindingArena
+{
+public:
+    static PathFindingArena& get();
+
+    void reset();
+
+    // visited positions, a nullptr node marks a position that can't be walked
+    Node*& visit(const Position& pos, bool& inserted);
+    size_t getVisitedCount() const { return m_visitedCount; }
+
+    Node* createNode(const Node& node);
+
+    // open list ordered by Node::totalCost,
+    // pushing a node that is already queued moves it after its cost was decreased.
+    void push(Node* node);
+    Node* pop();
+    bool empty() const { return m_heap.empty(); }
+
+private:
+    struct Slot
+    {
+        uint64_t key{ 0 };
+        uint32_t generation{ 0 };
+        Node* node{ nullptr };
+    };
+
+    static uint64_t packPosition(const Position& pos) { return static_cast<uint64_t>(static_cast<uint32_t>(pos.x)) << 24 | static_cast<uint64_t>(pos.y & 0xFFFF) << 8 | pos.z; }
+
+    Slot& findSlot(uint64_t key);
+    void grow();
+
+    void siftUp(size_t index);
+    void siftDown(size_t index);
+    void place(Node* node, size_t index) { m_heap[index] = node; node->heapIndex = index; }
+
+    static constexpr size_t NODES_PER_CHUNK = 4096;
+
+    std::vector<Slot> m_slots;
+    uint32_t m_generation{ 1 };
+    uint8_t m_shift{ 64 };
+    size_t m_visitedCount{ 0 };
+
+    std::vector<std::unique_ptr<Node[]>> m_chunks;
+    size_t m_usedNodes{ 0 };
+
+    std::vector<Node*> m_heap;
+};
+
+// Long range path finding over the minimap (HPA*).
+// Each minimap block is a cluster, its entrances are placed in the middle of every walkable
+// run along the borders with the neighbour clusters and linked with the cost of the shortest
+// path inside the cluster. Searches walk the entrances graph and only expand single tiles
+// inside the clusters of the resulting route, clusters are built lazily and rebuilt after
+// their walkability changes.
+class MinimapPathGraph
+{
+public:
+    static constexpr int CLUSTER_SIZE = 64;
+
+    // thread safe, meant to run on g_asyncDispatcher
+    PathFindResult_ptr findPath(const Position& start, const Position& goal);
+
+    void invalidate(const Position& pos);
+    void clear();
+
+private:
+    struct Entrance
+    {
+        uint16_t index; // tile inside the cluster
+        Position outside; // adjacent tile in the neighbour cluster
+        float outsideCost;
+        std::vector<std::pair<uint16_t, float>> edges; // entrance, cost
+    };
+
+    struct Cluster
+    {
+        Position origin;
+        std::array<uint8_t, CLUSTER_SIZE* CLUSTER_SIZE> speeds; // 0 when the tile can't be walked
+        std::vector<Entrance> entrances;
+
+        Position getPosition(uint16_t index) const { return origin.translated(index % CLUSTER_SIZE, index / CLUSTER_SIZE); }
+        const Entrance* findEntrance(uint16_t index) const;
+    };
+
+    static uint64_t getClusterKey(const Position& pos) { return static_cast<uint64_t>(pos.x / CLUSTER_SIZE) << 24 | static_cast<uint64_t>(pos.y / CLUSTER_SIZE) << 8 | pos.z; }
+    static uint16_t getTileIndex(const Position& pos) { return (pos.y % CLUSTER_SIZE) * CLUSTER_SIZE + (pos.x % CLUSTER_SIZE); }
+
+    const Cluster& getCluster(const Position& pos);
+    std::unique_ptr<Cluster> buildCluster(const Position& pos);
+    void applyInvalidations();
+
+    std::mutex m_mutex;
+    stdext::map<uint64_t, std::unique_ptr<Cluster>> m_clusters;
+
+    std::mutex m_invalidationMutex;
+    stdext::set<uint64_t> m_invalidated;
+    bool m_cleared{ false };
+};
@@ -24,6 +24,15 @@
 #include "game.h"
 #include "framework/net/inputmessage.h"
 
+#include <framework/core/clock.h>
+
+std::bitset<256> ProtocolGame::s_interceptedOpcodes;
+std::array<ProtocolGame::OpcodeProfile, 256> ProtocolGame::s_opcodeProfile;
+bool ProtocolGame::s_opcodeProfiling = false;
+uint32_t ProtocolGame::s_packetsPerSecond = 0;
+uint32_t ProtocolGame::s_packetsCount = 0;
+ticks_t ProtocolGame::s_packetsTime = 0;
+
 void ProtocolGame::login(const std::string_view accountName, const std::string_view accountPassword, const std::string_view host, uint16_t port,
                          const std::string_view characterName, const std::string_view authenticatorToken, const std::string_view sessionKey)
 {
@@ -74,4 +83,50 @@ void ProtocolGame::onError(const std::error_code& error)
 {
     g_game.processConnectionError(error);
     disconnect();
-}
\ No newline at end of file
+}
+
+void ProtocolGame::countPacket()
+{
+    ++s_packetsCount;
+
+    const ticks_t now = g_clock.millis();
+    if (now - s_packetsTime >= 1000) {
+        s_packetsPerSecond = s_packetsCount;
+        s_packetsCount = 0;
+        s_packetsTime = now;
+    }
+}
+
+uint32_t ProtocolGame::getPacketsPerSecond()
+{
+    // the rate is only updated by incoming packets, so it must not outlive them
+    const ticks_t elapsed = g_clock.millis() - s_packetsTime;
+    if (elapsed >= 2000)
+        return 0;
+    if (elapsed >= 1000)
+        return s_packetsCount;
+    return s_packetsPerSecond;
+}
+
+void ProtocolGame::resetPacketsPerSecond()
+{
+    s_packetsPerSecond = 0;
+    s_packetsCount = 0;
+    s_packetsTime = g_clock.millis();
+}
+
+void ProtocolGame::resetOpcodeProfile()
+{
+    s_opcodeProfile.fill({});
+}
+
+std::map<int, std::tuple<uint32_t, ticks_t>> ProtocolGame::getOpcodeProfile()
+{
+    std::map<int, std::tuple<uint32_t, ticks_t>> profile;
+    for (int opcode = 0; opcode < static_cast<int>(s_opcodeProfile.size()); ++opcode) {
+        const auto& [count, time] = s_opcodeProfile[opcode];
+        if (count > 0)
+            profile.emplace(opcode, std::make_tuple(count, time));
+    }
+    return profile;
+}
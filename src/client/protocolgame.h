@@ -27,6 +27,8 @@
 #include "declarations.h"
 #include "protocolcodes.h"
 
+#include <bitset>
+
 class ProtocolGame : public Protocol
 {
 public:
@@ -135,6 +137,17 @@ public:
     // otclient only
     void sendChangeMapAwareRange(int xrange, int yrange);
 
+    // only the opcodes intercepted by lua are passed to onOpcode
+    static void setOpcodeIntercepted(uint8_t opcode, bool intercepted) { s_interceptedOpcodes[opcode] = intercepted; }
+    static bool isOpcodeIntercepted(uint8_t opcode) { return s_interceptedOpcodes[opcode]; }
+
+    static void setOpcodeProfiling(bool enable) { s_opcodeProfiling = enable; }
+    static bool isOpcodeProfiling() { return s_opcodeProfiling; }
+    static void resetOpcodeProfile();
+    static std::map<int, std::tuple<uint32_t, ticks_t>> getOpcodeProfile(); // opcode -> count, parse time in micros
+    static uint32_t getPacketsPerSecond();
+    static void resetPacketsPerSecond();
+
 protected:
     void onConnect() override;
     void onRecv(const InputMessagePtr& inputMessage) override;
@@ -329,6 +342,21 @@ public:
     Position getPosition(const InputMessagePtr& msg);
 
 private:
+    struct OpcodeProfile
+    {
+        uint32_t count{ 0 };
+        ticks_t time{ 0 };
+    };
+
+    void countPacket();
+
+    static std::bitset<256> s_interceptedOpcodes;
+    static std::array<OpcodeProfile, 256> s_opcodeProfile;
+    static bool s_opcodeProfiling;
+    static uint32_t s_packetsPerSecond;
+    static uint32_t s_packetsCount;
+    static ticks_t s_packetsTime;
+
     bool m_enableSendExtendedOpcode{ false };
     bool m_gameInitialized{ false };
     bool m_mapKnown{ false };
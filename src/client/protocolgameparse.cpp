@@ -42,10 +42,14 @@ void ProtocolGame::parseMessage(const InputMessagePtr& msg)
     int opcode = -1;
     int prevOpcode = -1;
 
+    countPacket();
+
     try {
         while (!msg->eof()) {
             opcode = msg->getU8();
 
+            const ticks_t parseStart = s_opcodeProfiling ? stdext::micros() : 0;
+
             // must be > so extended will be enabled before GameStart.
             if (!g_game.getFeature(Otc::GameLoginPending)) {
                 if (!m_gameInitialized && opcode > Proto::GameServerFirstGameOpcode) {
@@ -55,11 +59,19 @@ void ProtocolGame::parseMessage(const InputMessagePtr& msg)
             }
 
             // try to parse in lua first
-            const int readPos = msg->getReadPos();
-            if (callLuaField<bool>("onOpcode", opcode, msg))
-                continue;
-            msg->setReadPos(readPos);
-            // restore read pos
+            if (s_interceptedOpcodes[opcode]) {
+                const int readPos = msg->getReadPos();
+                if (callLuaField<bool>("onOpcode", opcode, msg)) {
+                    if (s_opcodeProfiling) {
+                        auto& profile = s_opcodeProfile[opcode];
+                        ++profile.count;
+                        profile.time += stdext::micros() - parseStart;
+                    }
+                    continue;
+                }
+                msg->setReadPos(readPos);
+                // restore read pos
+            }
 
             switch (opcode) {
                 case Proto::GameServerLoginOrPendingState:
@@ -568,6 +580,12 @@ void ProtocolGame::parseMessage(const InputMessagePtr& msg)
                     break;
             }
             prevOpcode = opcode;
+
+            if (s_opcodeProfiling) {
+                auto& profile = s_opcodeProfile[opcode];
+                ++profile.count;
+                profile.time += stdext::micros() - parseStart;
+            }
         }
     } catch (const stdext::exception& e) {
         g_logger.error(stdext::format("ProtocolGame parse message exception (%d bytes, %d unread, last opcode is 0x%02x (%d), prev opcode is 0x%02x (%d)): %s"
@@ -963,6 +981,7 @@ void ProtocolGame::parseFloorDescription(const InputMessagePtr& msg)
     }
 
     const auto& range = g_map.getAwareRange();
+    const TileUpdateScope tileUpdates;
     setFloorDescription(msg, pos.x - range.left, pos.y - range.top, floor, range.horizontal(), range.vertical(), pos.z - floor, 0);
 }
 
@@ -1339,7 +1358,7 @@ void ProtocolGame::parseMagicEffect(const InputMessagePtr& msg)
                         return;
                     }
 
-                    const auto& missile = std::make_shared<Missile>();
+                    const auto& missile = stdext::make_pooled<Missile>();
                     missile->setId(shotId);
 
                     if (effectType == Otc::MAGIC_EFFECTS_CREATE_DISTANCEEFFECT)
@@ -1363,7 +1382,7 @@ void ProtocolGame::parseMagicEffect(const InputMessagePtr& msg)
                         continue;
                     }
 
-                    const auto& effect = std::make_shared<Effect>();
+                    const auto& effect = stdext::make_pooled<Effect>();
                     effect->setId(effectId);
                     g_map.addThing(effect, pos);
                     break;
@@ -1405,7 +1424,7 @@ void ProtocolGame::parseMagicEffect(const InputMessagePtr& msg)
         return;
     }
 
-    const auto& effect = std::make_shared<Effect>();
+    const auto& effect = stdext::make_pooled<Effect>();
     effect->setId(effectId);
     g_map.addThing(effect, pos);
 }
@@ -1442,7 +1461,7 @@ void ProtocolGame::parseDistanceMissile(const InputMessagePtr& msg)
         return;
     }
 
-    const auto& missile = std::make_shared<Missile>();
+    const auto& missile = stdext::make_pooled<Missile>();
     missile->setId(shotId);
     missile->setPath(fromPos, toPos);
     g_map.addThing(missile, fromPos);
@@ -2180,6 +2199,7 @@ void ProtocolGame::parseWalkWait(const InputMessagePtr& msg) const
 
 void ProtocolGame::parseFloorChangeUp(const InputMessagePtr& msg)
 {
+    const TileUpdateScope tileUpdates;
     const AwareRange& range = g_map.getAwareRange();
 
     auto pos = g_game.getFeature(Otc::GameMapMovePosition) ? getPosition(msg) : g_map.getCentralPosition();
@@ -2199,6 +2219,7 @@ void ProtocolGame::parseFloorChangeUp(const InputMessagePtr& msg)
 
 void ProtocolGame::parseFloorChangeDown(const InputMessagePtr& msg)
 {
+    const TileUpdateScope tileUpdates;
     const AwareRange& range = g_map.getAwareRange();
 
     auto pos = g_game.getFeature(Otc::GameMapMovePosition) ? getPosition(msg) : g_map.getCentralPosition();
@@ -2423,7 +2444,7 @@ void ProtocolGame::parseItemInfo(const InputMessagePtr& msg) const
     std::vector<std::tuple<ItemPtr, std::string>> list;
     const uint8_t size = msg->getU8();
     for (int_fast32_t i = 0; i < size; ++i) {
-        const auto& item = std::make_shared<Item>();
+        const auto& item = stdext::make_pooled<Item>();
         item->setId(msg->getU16());
         item->setCountOrSubType(g_game.getFeature(Otc::GameCountU16) ? msg->getU16() : msg->getU8());
 
@@ -2564,6 +2585,8 @@ void ProtocolGame::setMapDescription(const InputMessagePtr& msg, int x, int y, i
         zstep = -1;
     }
 
+    const TileUpdateScope tileUpdates;
+
     int skip = 0;
     for (int_fast32_t nz = startz; nz != endz + zstep; nz += zstep)
         skip = setFloorDescription(msg, x, y, nz, width, height, z - nz, skip);
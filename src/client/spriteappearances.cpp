@@ -50,12 +50,20 @@ void SpriteAppearances::terminate()
     unload();
 }
 
-bool SpriteAppearances::loadSpriteSheet(const SpriteSheetPtr& sheet) const
+bool SpriteAppearances::loadSpriteSheet(const SpriteSheetPtr& sheet, uint32_t generation)
 {
-    if (sheet->data)
-        return true;
-
     std::scoped_lock lock(sheet->m_mutex);
+    return decodeSpriteSheet(sheet, generation);
+}
+
+bool SpriteAppearances::decodeSpriteSheet(const SpriteSheetPtr& sheet, uint32_t generation)
+{
+    if (sheet->data) {
+        ++m_cacheHits;
+        return touchSpriteSheet(sheet, generation);
+    }
+
+    ++m_cacheMisses;
 
     try {
         const auto& path = stdext::format("%s%s", g_spriteAppearances.getPath(), sheet->file);
@@ -126,62 +134,159 @@ bool SpriteAppearances::loadSpriteSheet(const SpriteSheetPtr& sheet) const
         uint32_t data;
         std::memcpy(&data, decompressed.get() + 10, sizeof(uint32_t));
 
-        uint8_t* bufferStart = decompressed.get() + data;
+        const uint8_t* bufferStart = decompressed.get() + data;
 
-        // reverse channels
-        for (uint8_t* itr = bufferStart; itr < bufferStart + BYTES_IN_SPRITE_SHEET; itr += 4) {
-            std::swap(*(itr + 0), *(itr + 2));
-        }
+        sheet->data = std::make_unique<uint8_t[]>(BYTES_IN_SPRITE_SHEET);
 
-        // flip vertically
-        for (int y = 0; y < 192; ++y) {
-            uint8_t* itr1 = &bufferStart[y * SPRITE_SHEET_WIDTH_BYTES];
-            uint8_t* itr2 = &bufferStart[(SpriteSheet::SIZE - y - 1) * SPRITE_SHEET_WIDTH_BYTES];
+        // single pass over the bitmap: flip vertically, reverse channels (BGRA -> RGBA) and clear magenta.
+        // branchless per pixel, so the inner loop can be auto-vectorized.
+        for (int y = 0; y < SpriteSheet::SIZE; ++y) {
+            const uint8_t* src = &bufferStart[(SpriteSheet::SIZE - y - 1) * SPRITE_SHEET_WIDTH_BYTES];
+            uint8_t* dst = &sheet->data[y * SPRITE_SHEET_WIDTH_BYTES];
 
-            for (std::size_t x = 0; x < SPRITE_SHEET_WIDTH_BYTES; ++x) {
-                std::swap(*(itr1 + x), *(itr2 + x));
-            }
-        }
+            for (int x = 0; x < SpriteSheet::SIZE; ++x) {
+                uint32_t pixel;
+                std::memcpy(&pixel, src + x * 4, 4);
 
-        // fix magenta
-        for (int offset = 0; offset < BYTES_IN_SPRITE_SHEET; offset += 4) {
-            std::memcpy(&data, bufferStart + offset, 4);
-            if (data == 0xFF00FF) {
-                std::memset(bufferStart + offset, 0x00, 4);
+                pixel = (pixel & 0xFF00FF00) | ((pixel >> 16) & 0xFF) | ((pixel & 0xFF) << 16);
+                pixel &= -static_cast<uint32_t>(pixel != 0xFF00FF);
+
+                std::memcpy(dst + x * 4, &pixel, 4);
             }
         }
 
-        sheet->data = std::make_unique<uint8_t[]>(LZMA_UNCOMPRESSED_SIZE);
-        std::memcpy(sheet->data.get(), bufferStart, BYTES_IN_SPRITE_SHEET);
-
-        return true;
+        return touchSpriteSheet(sheet, generation);
     } catch (const std::exception& e) {
         g_logger.error(stdext::format("Failed to load single sprite sheet '%s': %s", sheet->file, e.what()));
         return false;
     }
 }
 
+void SpriteAppearances::prefetchSpriteSheets(const std::vector<uint32_t>& spriteIds)
+{
+    const SpriteSheet* lastSheet = nullptr;
+    for (const uint32_t id : spriteIds) {
+        // sprites of the same thing are usually laid out in the same sheet
+        if (lastSheet && static_cast<int>(id) >= lastSheet->firstId && static_cast<int>(id) <= lastSheet->lastId)
+            continue;
+
+        const auto& sheet = getSheetBySpriteId(id, false);
+        if (!sheet)
+            continue;
+
+        lastSheet = sheet.get();
+
+        {
+            // a locked sheet is being decoded or copied by another thread already
+            std::unique_lock sheetLock(sheet->m_mutex, std::try_to_lock);
+            if (!sheetLock.owns_lock() || sheet->data)
+                continue;
+        }
+
+        if (sheet->prefetching.exchange(true))
+            continue;
+
+        g_asyncDispatcher.dispatch([this, sheet, generation = m_cacheGeneration.load()] {
+            loadSpriteSheet(sheet, generation);
+            sheet->prefetching = false;
+        });
+    }
+}
+
+bool SpriteAppearances::touchSpriteSheet(const SpriteSheetPtr& sheet, uint32_t generation)
+{
+    std::scoped_lock lock(m_cacheMutex);
+
+    // finished after unload(), the sheet no longer belongs to the cache
+    if (generation != m_cacheGeneration) {
+        sheet->data.reset();
+        return false;
+    }
+
+    if (sheet->cached) {
+        m_cacheLru.splice(m_cacheLru.begin(), m_cacheLru, sheet->lruIt);
+        return true;
+    }
+
+    m_cacheLru.emplace_front(sheet);
+    sheet->lruIt = m_cacheLru.begin();
+    sheet->cached = true;
+    m_cacheSize += BYTES_IN_SPRITE_SHEET;
+
+    evictSpriteSheets(sheet.get());
+    return true;
+}
+
+void SpriteAppearances::evictSpriteSheets(const SpriteSheet* keep)
+{
+    if (m_cacheLimit == 0)
+        return;
+
+    // walk from the least recently used sheet, skipping sheets that are in use by other threads
+    for (auto it = m_cacheLru.end(); m_cacheSize > m_cacheLimit && it != m_cacheLru.begin();) {
+        const SpriteSheetPtr sheet = *--it;
+        if (sheet.get() == keep)
+            continue;
+
+        std::unique_lock sheetLock(sheet->m_mutex, std::try_to_lock);
+        if (!sheetLock.owns_lock())
+            continue;
+
+        sheet->data.reset();
+        sheet->cached = false;
+        it = m_cacheLru.erase(it);
+        m_cacheSize -= BYTES_IN_SPRITE_SHEET;
+        ++m_cacheEvictions;
+    }
+}
+
+void SpriteAppearances::setSheetCacheLimit(uint32_t mb)
+{
+    std::scoped_lock lock(m_cacheMutex);
+    m_cacheLimit = static_cast<std::size_t>(mb) * 1024 * 1024;
+    evictSpriteSheets(nullptr);
+}
+
 void SpriteAppearances::unload()
 {
+    std::scoped_lock lock(m_cacheMutex);
+    for (const auto& sheet : m_cacheLru)
+        sheet->cached = false;
+    m_cacheLru.clear();
+    m_cacheSize = 0;
+    ++m_cacheGeneration;
+
     m_spritesCount = 0;
     m_sheets.clear();
 }
 
+void SpriteAppearances::addSpriteSheet(const SpriteSheetPtr& sheet)
+{
+    // catalog-content.json is usually already sorted, so this is almost always an append
+    const auto it = std::upper_bound(m_sheets.begin(), m_sheets.end(), sheet->firstId, [](int firstId, const SpriteSheetPtr& other) {
+        return firstId < other->firstId;
+    });
+
+    m_sheets.emplace(it, sheet);
+}
+
 SpriteSheetPtr SpriteAppearances::getSheetBySpriteId(int id, bool load /* = true */)
 {
     if (id == 0) {
         return nullptr;
     }
 
-    // find sheet
-    const auto sheetIt = std::find_if(m_sheets.begin(), m_sheets.end(), [=](const SpriteSheetPtr& sheet) {
-        return id >= sheet->firstId && id <= sheet->lastId;
+    // find the last sheet starting at or before id
+    const auto sheetIt = std::upper_bound(m_sheets.begin(), m_sheets.end(), id, [](int id, const SpriteSheetPtr& sheet) {
+        return id < sheet->firstId;
     });
 
-    if (sheetIt == m_sheets.end())
+    if (sheetIt == m_sheets.begin())
         return nullptr;
 
-    const auto& sheet = *sheetIt;
+    const auto& sheet = *std::prev(sheetIt);
+    if (id > sheet->lastId)
+        return nullptr;
 
     if (load && !loadSpriteSheet(sheet))
         return nullptr;
@@ -192,11 +297,17 @@ SpriteSheetPtr SpriteAppearances::getSheetBySpriteId(int id, bool load /* = true
 ImagePtr SpriteAppearances::getSpriteImage(int id)
 {
     try {
-        const auto& sheet = getSheetBySpriteId(id);
+        const auto& sheet = getSheetBySpriteId(id, false);
         if (!sheet) {
             return nullptr;
         }
 
+        // hold the sheet so it cannot be evicted while being copied
+        std::scoped_lock lock(sheet->m_mutex);
+        if (!decodeSpriteSheet(sheet, m_cacheGeneration)) {
+            return nullptr;
+        }
+
         const Size& size = sheet->getSpriteSize();
 
         const auto& image = std::make_shared<Image>(size);
@@ -240,14 +351,17 @@ void SpriteAppearances::saveSpriteToFile(int id, const std::string& file)
 
 void SpriteAppearances::saveSheetToFileBySprite(int id, const std::string& file)
 {
-    if (const auto& sheet = getSheetBySpriteId(id)) {
-        Image image({ SpriteSheet::SIZE }, 4, sheet->data.get());
-        image.savePNG(file);
+    if (const auto& sheet = getSheetBySpriteId(id, false)) {
+        saveSheetToFile(sheet, file);
     }
 }
 
 void SpriteAppearances::saveSheetToFile(const SpriteSheetPtr& sheet, const std::string& file)
 {
+    std::scoped_lock lock(sheet->m_mutex);
+    if (!decodeSpriteSheet(sheet, m_cacheGeneration))
+        return;
+
     Image image({ SpriteSheet::SIZE }, 4, sheet->data.get());
     image.savePNG(file);
 }
\ No newline at end of file
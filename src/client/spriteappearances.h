@@ -67,6 +67,11 @@ public:
     std::mutex m_mutex;
     std::unique_ptr<uint8_t[]> data;
     std::string file;
+
+    // position in SpriteAppearances LRU, guarded by its cache mutex
+    std::list<SpriteSheetPtr>::iterator lruIt;
+    bool cached{ false };
+    std::atomic_bool prefetching{ false };
 };
 
 //@bindsingleton g_spriteAppearances
@@ -84,20 +89,48 @@ public:
     void setPath(const std::string& path) { m_path = path; }
     std::string getPath() const { return m_path; }
 
-    bool loadSpriteSheet(const SpriteSheetPtr& sheet) const;
+    bool loadSpriteSheet(const SpriteSheetPtr& sheet) { return loadSpriteSheet(sheet, m_cacheGeneration); }
     void saveSheetToFileBySprite(int id, const std::string& file);
     void saveSheetToFile(const SpriteSheetPtr& sheet, const std::string& file);
     SpriteSheetPtr getSheetBySpriteId(int id, bool load = true);
+    void prefetchSpriteSheets(const std::vector<uint32_t>& spriteIds);
 
-    void addSpriteSheet(const SpriteSheetPtr& sheet) { m_sheets.emplace_back(sheet); }
+    void addSpriteSheet(const SpriteSheetPtr& sheet);
 
     ImagePtr getSpriteImage(int id);
     void saveSpriteToFile(int id, const std::string& file);
 
+    // decoded sheets memory budget in MB, 0 = unlimited
+    void setSheetCacheLimit(uint32_t mb);
+    uint32_t getSheetCacheLimit() { return m_cacheLimit / (1024 * 1024); }
+    uint32_t getSheetCacheSize() { return m_cacheSize / (1024 * 1024); }
+    uint64_t getSheetCacheHits() { return m_cacheHits; }
+    uint64_t getSheetCacheMisses() { return m_cacheMisses; }
+    uint64_t getSheetCacheEvictions() { return m_cacheEvictions; }
+
 private:
+    bool loadSpriteSheet(const SpriteSheetPtr& sheet, uint32_t generation);
+
+    // sheet->m_mutex must be held by the caller. generation is the cache generation the
+    // load was requested in, the decoded data is dropped when the cache was unloaded since.
+    bool decodeSpriteSheet(const SpriteSheetPtr& sheet, uint32_t generation);
+    bool touchSpriteSheet(const SpriteSheetPtr& sheet, uint32_t generation);
+    void evictSpriteSheets(const SpriteSheet* keep);
+
     uint32_t m_spritesCount{ 0 };
+
+    // sorted by firstId, so lookups can binary search
     std::vector<SpriteSheetPtr> m_sheets;
     std::string m_path;
+
+    std::mutex m_cacheMutex;
+    std::list<SpriteSheetPtr> m_cacheLru; // most recently used first
+    std::atomic<std::size_t> m_cacheLimit{ 0 };
+    std::atomic<uint32_t> m_cacheGeneration{ 0 };
+    std::atomic<std::size_t> m_cacheSize{ 0 };
+    std::atomic<uint64_t> m_cacheHits{ 0 };
+    std::atomic<uint64_t> m_cacheMisses{ 0 };
+    std::atomic<uint64_t> m_cacheEvictions{ 0 };
 };
 
 extern SpriteAppearances g_spriteAppearances;
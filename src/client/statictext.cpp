@@ -147,6 +147,5 @@ void StaticText::compose()
             text += "\n";
     }
 
-    m_cachedText.setText(text);
-    m_cachedText.wrapText(275);
+    m_cachedText.setText(text, 275);
 }
\ No newline at end of file
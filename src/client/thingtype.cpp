@@ -26,6 +26,7 @@
 #include "map.h"
 #include "spriteappearances.h"
 #include "spritemanager.h"
+#include "thingtypemanager.h"
 
 #include <framework/core/eventdispatcher.h>
 #include <framework/core/asyncdispatcher.h>
@@ -632,7 +633,7 @@ void ThingType::draw(const Point& dest, int layer, int xPattern, int yPattern, i
     if (animationPhase >= m_animationPhases)
         return;
 
-    const auto& texture = getTexture(animationPhase); // texture might not exists, neither its rects.
+    TexturePtr texture = getTexture(animationPhase); // texture might not exists, neither its rects.
     if (!texture)
         return;
 
@@ -643,7 +644,18 @@ void ThingType::draw(const Point& dest, int layer, int xPattern, int yPattern, i
         return;
 
     const auto& textureOffset = textureData.pos[frameIndex].offsets;
-    const auto& textureRect = textureData.pos[frameIndex].rects;
+    Rect textureRect = textureData.pos[frameIndex].rects;
+
+    // shaders sample around the frame, in an atlas page that is other sprites
+    if (textureData.atlasRect.isValid()) {
+        const auto* shader = g_drawPool.getShaderProgram();
+        if (shader && !g_painter->isReplaceColorShader(shader)) {
+            if (const auto& standalone = getStandaloneTexture(animationPhase)) {
+                texture = standalone;
+                textureRect.translate(-textureData.atlasRect.left(), -textureData.atlasRect.top());
+            }
+        }
+    }
 
     const Rect screenRect(dest + (textureOffset - m_displacement - (m_size.toPoint() - Point(1)) * g_gameConfig.getSpriteSize()) * g_drawPool.getScaleFactor(), textureRect.size() * g_drawPool.getScaleFactor());
 
@@ -694,12 +706,63 @@ TexturePtr ThingType::getTexture(int animationPhase)
     return nullptr;
 }
 
+void ThingType::prefetchSpriteSheets()
+{
+    if (m_null || hasTexture() || m_loading || !g_game.isUsingProtobuf())
+        return;
+
+    g_spriteAppearances.prefetchSpriteSheets(m_spritesIndex);
+}
+
 void ThingType::loadTexture(int animationPhase)
 {
     auto& textureData = m_textureData[animationPhase];
     if (textureData.source)
         return;
 
+    const auto& fullImage = createTextureImage(animationPhase, textureData.pos);
+    if (!fullImage)
+        return;
+
+    if (m_opaque == -1)
+        m_opaque = !fullImage->hasTransparentPixel();
+
+    // creatures are left out, outfit masks sample around the frame; the other things
+    // sampled by a shader are drawn from getStandaloneTexture.
+    if (m_category != ThingCategoryCreature && g_things.isTextureAtlasEnabled()) {
+        Rect atlasRect;
+        if (const auto& page = g_things.getTextureAtlas().add(fullImage, atlasRect)) {
+            for (auto& posData : textureData.pos) {
+                posData.rects.translate(atlasRect.topLeft());
+                posData.originRects.translate(atlasRect.topLeft());
+            }
+
+            textureData.atlasRect = atlasRect;
+            textureData.source = page;
+            ++m_textureGeneration;
+            return;
+        }
+    }
+
+    textureData.source = std::make_shared<Texture>(fullImage, true, false);
+    ++m_textureGeneration;
+}
+
+const TexturePtr& ThingType::getStandaloneTexture(int animationPhase)
+{
+    // built again on demand, the atlas doesn't keep the images it packed
+    auto& textureData = m_textureData[animationPhase];
+    if (!textureData.standalone) {
+        std::vector<TextureData::Pos> pos;
+        if (const auto& image = createTextureImage(animationPhase, pos))
+            textureData.standalone = std::make_shared<Texture>(image, true, false);
+    }
+
+    return textureData.standalone;
+}
+
+ImagePtr ThingType::createTextureImage(int animationPhase, std::vector<TextureData::Pos>& pos)
+{
     // we don't need layers in common items, they will be pre-drawn
     int textureLayers = 1;
     int numLayers = m_layers;
@@ -717,7 +780,7 @@ void ThingType::loadTexture(int animationPhase)
 
     static Color maskColors[] = { Color::red, Color::green, Color::blue, Color::yellow };
 
-    textureData.pos.resize(indexSize);
+    pos.resize(indexSize);
     for (int z = 0; z < m_numPatternZ; ++z) {
         for (int y = 0; y < m_numPatternY; ++y) {
             for (int x = 0; x < m_numPatternX; ++x) {
@@ -733,7 +796,7 @@ void ThingType::loadTexture(int animationPhase)
                             const uint32_t spriteIndex = getSpriteIndex(-1, -1, spriteMask ? 1 : l, x, y, z, animationPhase);
                             const auto& spriteImage = g_sprites.getSpriteImage(m_spritesIndex[spriteIndex]);
                             if (!spriteImage) {
-                                return;
+                                return nullptr;
                             }
 
                             // verifies that the first block in the lower right corner is transparent.
@@ -770,7 +833,7 @@ void ThingType::loadTexture(int animationPhase)
                         }
                     }
 
-                    auto& posData = textureData.pos[frameIndex];
+                    auto& posData = pos[frameIndex];
                     posData.rects = { framePos + Point(m_size.width(), m_size.height()) * g_gameConfig.getSpriteSize() - Point(1), framePos };
                     for (int fx = framePos.x; fx < framePos.x + m_size.width() * g_gameConfig.getSpriteSize(); ++fx) {
                         for (int fy = framePos.y; fy < framePos.y + m_size.height() * g_gameConfig.getSpriteSize(); ++fy) {
@@ -795,10 +858,46 @@ void ThingType::loadTexture(int animationPhase)
     if (m_opacity < 1.0f)
         fullImage->setTransparentPixel(true);
 
-    if (m_opaque == -1)
-        m_opaque = !fullImage->hasTransparentPixel();
+    return fullImage;
+}
 
-    textureData.source = std::make_shared<Texture>(fullImage, true, false);
+ImagePtr ThingType::getFrameImage(int layer, int xPattern, int yPattern, int zPattern, int animationPhase)
+{
+    if (m_null || animationPhase >= m_animationPhases)
+        return nullptr;
+
+    const auto& image = std::make_shared<Image>(m_size * g_gameConfig.getSpriteSize());
+
+    if (g_game.isUsingProtobuf()) {
+        const auto& spriteImage = g_sprites.getSpriteImage(m_spritesIndex[getSpriteIndex(-1, -1, layer, xPattern, yPattern, zPattern, animationPhase)]);
+        if (!spriteImage)
+            return nullptr;
+
+        image->blit(Point(0), spriteImage);
+        return image;
+    }
+
+    for (int h = 0; h < m_size.height(); ++h) {
+        for (int w = 0; w < m_size.width(); ++w) {
+            const auto& spriteImage = g_sprites.getSpriteImage(m_spritesIndex[getSpriteIndex(w, h, layer, xPattern, yPattern, zPattern, animationPhase)]);
+            if (spriteImage)
+                image->blit(Point(m_size.width() - w - 1, m_size.height() - h - 1) * g_gameConfig.getSpriteSize(), spriteImage);
+        }
+    }
+
+    return image;
+}
+
+void ThingType::unload()
+{
+    for (const auto& textureData : m_textureData) {
+        if (textureData.atlasRect.isValid())
+            g_things.getTextureAtlas().remove(textureData.source, textureData.atlasRect);
+    }
+
+    m_textureData.clear();
+    m_textureData.resize(m_animationPhases);
+    ++m_textureGeneration;
 }
 
 Size ThingType::getBestTextureDimension(int w, int h, int count)
@@ -375,12 +375,14 @@ public:
     bool isCreature() const { return m_category == ThingCategoryCreature; }
 
     bool hasTexture() const { return !m_textureData.empty() && m_textureData[0].source != nullptr; }
+    bool hasTexture(int animationPhase) const { return animationPhase < static_cast<int>(m_textureData.size()) && m_textureData[animationPhase].source != nullptr; }
+    // for draws that reuse the texture without getTexture, so it is not collected meanwhile
+    void markTextureUsed() { m_lastTimeUsage.restart(); }
+    // changes whenever the textures are loaded or unloaded, an atlas region may be reused meanwhile
+    uint16_t getTextureGeneration() const { return m_textureGeneration; }
     const Timer getLastTimeUsage() const { return m_lastTimeUsage; }
 
-    void unload() {
-        m_textureData.clear();
-        m_textureData.resize(m_animationPhases);
-    }
+    void unload();
 
     PLAYER_ACTION getDefaultAction() { return m_defaultAction; }
 
@@ -392,6 +394,9 @@ public:
     void setPathable(bool var);
     int getExactHeight();
     TexturePtr getTexture(int animationPhase);
+    // sprites of a single frame, without the texture trimming and mask recoloring
+    ImagePtr getFrameImage(int layer, int xPattern, int yPattern, int zPattern, int animationPhase);
+    void prefetchSpriteSheets();
 
     std::string getName() { return m_name; }
     std::string getDescription() { return m_description; }
@@ -412,9 +417,14 @@ private:
         };
 
         TexturePtr source;
+        TexturePtr standalone; // the frames of an atlas source, for draws with a shader
         std::vector<Pos> pos;
+        Rect atlasRect; // valid when source is a texture atlas page
     };
 
+    ImagePtr createTextureImage(int animationPhase, std::vector<TextureData::Pos>& pos);
+    const TexturePtr& getStandaloneTexture(int animationPhase);
+
     void prepareTextureLoad(const std::vector<Size>& sizes, const std::vector<int>& total_sprites);
 
     uint32_t getSpriteIndex(int w, int h, int l, int x, int y, int z, int a) const;
@@ -463,6 +473,7 @@ private:
     std::vector<TextureData> m_textureData;
 
     std::atomic_bool m_loading;
+    std::atomic_uint16_t m_textureGeneration{ 0 };
 
     Timer m_lastTimeUsage;
 
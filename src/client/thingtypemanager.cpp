@@ -94,6 +94,8 @@ void ThingTypeManager::terminate()
         m_thingType.clear();
 
     m_nullThingType = nullptr;
+    m_outfitCache.clear();
+    m_textureAtlas.clear();
 
     if (m_gc.event) {
         m_gc.event->cancel();
@@ -112,6 +114,8 @@ bool ThingTypeManager::loadDat(std::string file)
     m_datLoaded = false;
     m_datSignature = 0;
     m_contentRevision = 0;
+    m_outfitCache.clear();
+    m_textureAtlas.clear();
     try {
         file = g_resources.guessFilePath(file, "dat");
 
@@ -187,6 +191,8 @@ bool ThingTypeManager::loadOtml(std::string file)
 
 bool ThingTypeManager::loadAppearances(const std::string& file)
 {
+    m_outfitCache.clear();
+    m_textureAtlas.clear();
     try {
         int spritesCount = 0;
         std::string appearancesFile;
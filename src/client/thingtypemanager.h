@@ -23,6 +23,8 @@
 #pragma once
 
 #include <framework/global.h>
+#include <framework/graphics/textureatlas.h>
+#include "outfittexturecache.h"
 #include "thingtype.h"
 
 #ifdef FRAMEWORK_EDITOR
@@ -72,6 +74,18 @@ public:
     uint32_t getDatSignature() { return m_datSignature; }
     uint16_t getContentRevision() { return m_contentRevision; }
 
+    TextureAtlas& getTextureAtlas() { return m_textureAtlas; }
+    void setTextureAtlasEnabled(bool v) { m_textureAtlasEnabled = v; }
+    bool isTextureAtlasEnabled() { return m_textureAtlasEnabled; }
+    uint32_t getTextureAtlasPages() { return m_textureAtlas.getPagesCount(); }
+    uint32_t getTextureAtlasRegions() { return m_textureAtlas.getRegionsCount(); }
+
+    OutfitTextureCache& getOutfitCache() { return m_outfitCache; }
+    void setOutfitCacheEnabled(bool v) { m_outfitCacheEnabled = v; if (!v) m_outfitCache.clear(); }
+    bool isOutfitCacheEnabled() { return m_outfitCacheEnabled; }
+    uint32_t getOutfitCacheHits() { return m_outfitCache.getHits(); }
+    uint32_t getOutfitCacheMisses() { return m_outfitCache.getMisses(); }
+
     bool isDatLoaded() { return m_datLoaded; }
     bool isValidDatId(uint16_t id, ThingCategory category) const { return id >= 1 && id < m_thingTypes[category].size(); }
 
@@ -88,12 +102,17 @@ private:
     ThingTypePtr m_nullThingType;
 
     bool m_datLoaded{ false };
+    bool m_textureAtlasEnabled{ true };
+    bool m_outfitCacheEnabled{ true };
 
     uint32_t m_datSignature{ 0 };
     uint16_t m_contentRevision{ 0 };
 
     GarbageCollection m_gc;
 
+    TextureAtlas m_textureAtlas;
+    OutfitTextureCache m_outfitCache;
+
 #ifdef FRAMEWORK_EDITOR
     ItemTypePtr m_nullItemType;
     ItemTypeList m_reverseItemTypes;
@@ -37,6 +37,9 @@
 #include "statictext.h"
 #include "localplayer.h"
 
+MapView::RetainedDrawStats Tile::retainedDrawStats;
+bool Tile::retainedDrawProfiling = false;
+
 Tile::Tile(const Position& position) : m_position(position) {}
 
 void Tile::drawThing(const ThingPtr& thing, const Point& dest, int flags, LightView* lightView)
@@ -58,18 +61,22 @@ void Tile::draw(const Point& dest, const MapPosInfo& mapRect, int flags, LightVi
     }
 #endif
 
-    for (const auto& thing : m_things) {
-        if (!thing->isGround() && !thing->isGroundBorder() && !thing->isOnBottom())
-            break;
+    if (flags & Otc::DrawRetained && flags & Otc::DrawThings) {
+        drawRetained(dest, flags, lightView);
+    } else {
+        for (const auto& thing : m_things) {
+            if (!thing->isGround() && !thing->isGroundBorder() && !thing->isOnBottom())
+                break;
 
-        drawThing(thing, dest, flags, lightView);
-    }
+            drawThing(thing, dest, flags, lightView);
+        }
 
-    if (hasCommonItem()) {
-        for (auto it = m_things.rbegin(); it != m_things.rend(); ++it) {
-            const auto& item = *it;
-            if (!item->isCommon()) continue;
-            drawThing(item, dest, flags, lightView);
+        if (hasCommonItem()) {
+            for (auto it = m_things.rbegin(); it != m_things.rend(); ++it) {
+                const auto& item = *it;
+                if (!item->isCommon()) continue;
+                drawThing(item, dest, flags, lightView);
+            }
         }
     }
 
@@ -85,6 +92,91 @@ void Tile::draw(const Point& dest, const MapPosInfo& mapRect, int flags, LightVi
     drawAttachedParticlesEffect(dest);
 }
 
+void Tile::drawRetained(const Point& dest, int flags, LightView* lightView)
+{
+    if (!m_retainedDrawsUpdated)
+        updateRetainedDraws();
+
+    auto& stats = retainedDrawStats;
+    const float scale = g_drawPool.getScaleFactor();
+
+    // two clock reads per thing are too much to pay on every frame
+    const bool profiling = retainedDrawProfiling;
+    ticks_t lastTime = profiling ? stdext::micros() : 0;
+    const auto lap = [profiling, &lastTime](uint64_t& micros) {
+        if (!profiling)
+            return;
+
+        const ticks_t now = stdext::micros();
+        micros += now - lastTime;
+        lastTime = now;
+    };
+
+    for (auto& draw : m_retainedDraws) {
+        const uint64_t key = draw.thing->isItem() ? static_cast<Item*>(draw.thing.get())->getRetainedDrawKey() : 0;
+        if (key == 0) {
+            draw.key = 0;
+            drawThing(draw.thing, dest, flags, lightView);
+            ++stats.liveThings;
+            lap(stats.liveMicros);
+            continue;
+        }
+
+        const Point thingDest = dest - m_drawElevation * scale;
+        if (key != draw.key || scale != draw.scale) {
+            g_drawPool.beginRecording(draw.commands, thingDest);
+            draw.thing->draw(thingDest, true, lightView);
+            draw.recorded = g_drawPool.endRecording();
+            draw.key = key;
+            draw.scale = scale;
+            stats.animatedCommands += draw.commands.commands.size();
+            lap(stats.animatedMicros);
+        } else if (draw.recorded) {
+            g_drawPool.addRetained(draw.commands, thingDest);
+            stats.staticCommands += draw.commands.commands.size();
+            lap(stats.staticMicros);
+        } else { // not recorded again until it changes
+            draw.thing->draw(thingDest, true, lightView);
+            ++stats.liveThings;
+            lap(stats.liveMicros);
+        }
+
+        if (draw.thing->hasElevation())
+            m_drawElevation = std::min<uint8_t>(m_drawElevation + draw.thing->getElevation(), g_gameConfig.getTileMaxElevation());
+    }
+}
+
+void Tile::updateRetainedDraws()
+{
+    std::vector<RetainedDraw> draws;
+
+    // the things that didn't move keep their commands
+    const auto add = [&](const ThingPtr& thing) {
+        const auto it = std::find_if(m_retainedDraws.begin(), m_retainedDraws.end(), [&](const RetainedDraw& draw) { return draw.thing == thing; });
+        if (it != m_retainedDraws.end())
+            draws.emplace_back(std::move(*it));
+        else
+            draws.emplace_back().thing = thing;
+    };
+
+    for (const auto& thing : m_things) {
+        if (!thing->isGround() && !thing->isGroundBorder() && !thing->isOnBottom())
+            break;
+
+        add(thing);
+    }
+
+    if (hasCommonItem()) {
+        for (auto it = m_things.rbegin(); it != m_things.rend(); ++it) {
+            if ((*it)->isCommon())
+                add(*it);
+        }
+    }
+
+    m_retainedDraws = std::move(draws);
+    m_retainedDrawsUpdated = true;
+}
+
 void Tile::drawCreature(const Point& dest, const MapPosInfo& mapRect, int flags, bool forceDraw, LightView* lightView)
 {
     if (!forceDraw && !m_drawTopAndCreature)
@@ -153,6 +245,12 @@ void Tile::clean()
 #endif
 }
 
+void Tile::onStartAttachEffect(const AttachedEffectPtr& /*effect*/)
+{
+    // an attached effect can make an empty tile drawable
+    g_map.notificateTileUpdate(m_position, nullptr, Otc::OPERATION_ADD);
+}
+
 void Tile::addWalkingCreature(const CreaturePtr& creature)
 {
     m_walkingCreatures.emplace_back(creature);
@@ -240,11 +338,16 @@ void Tile::addThing(const ThingPtr& thing, int stackPos)
         stackPos = size;
 
     m_things.insert(m_things.begin() + stackPos, thing);
+    m_retainedDrawsUpdated = false;
+
+    if (thing->isCreature())
+        g_map.indexCreature(thing->static_self_cast<Creature>(), m_position);
 
     // get the elevation status before analyze the new item.
     const bool hasElev = hasElevation();
 
     setThingFlag(thing);
+    g_map.updateOcclusion(m_position);
     checkForDetachableThing();
 
     if (size > g_gameConfig.getTileMaxThings())
@@ -288,8 +391,13 @@ bool Tile::removeThing(const ThingPtr thing)
         return false;
 
     m_things.erase(it);
+    m_retainedDrawsUpdated = false;
+
+    if (thing->isCreature())
+        g_map.unindexCreature(thing->static_self_cast<Creature>(), m_position);
 
     recalculateThingFlag();
+    g_map.updateOcclusion(m_position);
     if (thing->hasElevation())
         --m_elevation;
 
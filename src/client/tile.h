@@ -92,10 +92,15 @@ enum TileThingType : uint32_t
 class Tile : public AttachableObject
 {
 public:
+    // accumulated by drawRetained along the current map frame
+    static MapView::RetainedDrawStats retainedDrawStats;
+    static bool retainedDrawProfiling; // measures the micros of retainedDrawStats
+
     Tile(const Position& position);
 
     LuaObjectPtr attachedObjectToLuaObject() override { return asLuaObject(); }
     bool isTile() override { return true; }
+    void onStartAttachEffect(const AttachedEffectPtr& effect) override;
 
     void onAddInMapView();
     void draw(const Point& dest, const MapPosInfo& mapRect, int flags, LightView* lightView = nullptr);
@@ -220,6 +225,8 @@ private:
     void drawTop(const Point& dest, int flags, bool forceDraw, LightView* lightView = nullptr);
     void drawCreature(const Point& dest, const MapPosInfo& mapRect, int flags, bool forceDraw, LightView* lightView = nullptr);
     void drawThing(const ThingPtr& thing, const Point& dest, int flags, LightView* lightView);
+    void drawRetained(const Point& dest, int flags, LightView* lightView);
+    void updateRetainedDraws();
 
     void setThingFlag(const ThingPtr& thing);
 
@@ -253,11 +260,25 @@ private:
     std::vector<EffectPtr> m_effects;
     std::vector<TilePtr> m_tilesRedraw;
 
+    // ground, borders, bottom and common items in draw order, with the commands they added
+    // when key was recorded; key is 0, or recorded false, when the thing is drawn as usual
+    struct RetainedDraw
+    {
+        ThingPtr thing;
+        uint64_t key{ 0 };
+        float scale{ 0.f };
+        bool recorded{ false };
+        DrawPool::RetainedCommands commands;
+    };
+
+    std::vector<RetainedDraw> m_retainedDraws;
+
     ThingPtr m_highlightThing;
 
     TileSelectType m_selectType{ TileSelectType::NONE };
 
     bool m_drawTopAndCreature{ true };
+    bool m_retainedDrawsUpdated{ false };
 
 #ifndef BOT_PROTECTION
     ticks_t m_timer = 0;
@@ -72,6 +72,12 @@ public:
 
     std::vector<CreaturePtr> getSpectators(bool multiFloor = false) { return m_mapView->getSpectators(multiFloor); }
     std::vector<CreaturePtr> getSightSpectators(bool multiFloor = false) { return m_mapView->getSightSpectators(multiFloor); }
+    std::map<std::string, uint64_t> getVisibleTilesStats() { return m_mapView->getVisibleTilesStats(); }
+    std::map<std::string, uint64_t> getRetainedDrawStats() { return m_mapView->getRetainedDrawStats(); }
+    void setRetainedDraw(bool enable) { m_mapView->setRetainedDraw(enable); }
+    bool isRetainedDraw() { return m_mapView->isRetainedDraw(); }
+    void setRetainedDrawProfiling(bool enable) { m_mapView->setRetainedDrawProfiling(enable); }
+    bool isRetainedDrawProfiling() { return m_mapView->isRetainedDrawProfiling(); }
     bool isInRange(const Position& pos) { return m_mapView->isInRange(pos); }
 
     PainterShaderProgramPtr getShader() { return m_mapView->getShader(); }
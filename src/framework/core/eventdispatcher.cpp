@@ -39,12 +39,15 @@ void EventDispatcher::init() {
 
 void EventDispatcher::shutdown()
 {
+    // polling is over, the wheel now belongs to the thread shutting it down
+    m_pollThreadId = getThreadId();
+
     do {
         executeEvents();
         mergeEvents();
     } while (!m_eventList.empty());
 
-    m_scheduledEventList.clear();
+    clearScheduledEvents();
     m_deferEventList.clear();
     m_threads.clear();
 
@@ -53,6 +56,8 @@ void EventDispatcher::shutdown()
 
 void EventDispatcher::poll()
 {
+    m_pollThreadId = getThreadId();
+
     mergeEvents();
     executeEvents();
     executeScheduledEvents();
@@ -69,9 +74,8 @@ void EventDispatcher::startEvent(const ScheduledEventPtr& event)
         return;
     }
 
-    const auto& thread = getThreadTask();
-    std::scoped_lock lock(thread->mutex);
-    thread->scheduledEventList.emplace_back(event);
+    event->m_dispatcher = this;
+    getThreadTask()->scheduledEventList.push(event);
 }
 
 ScheduledEventPtr EventDispatcher::scheduleEvent(const std::function<void()>& callback, int delay)
@@ -81,9 +85,11 @@ ScheduledEventPtr EventDispatcher::scheduleEvent(const std::function<void()>& ca
 
     assert(delay >= 0);
 
-    const auto& thread = getThreadTask();
-    std::scoped_lock lock(thread->mutex);
-    return thread->scheduledEventList.emplace_back(std::make_shared<ScheduledEvent>(callback, delay, 1));
+    const auto& event = std::make_shared<ScheduledEvent>(callback, delay, 1);
+    event->m_dispatcher = this;
+
+    getThreadTask()->scheduledEventList.push(event);
+    return event;
 }
 
 ScheduledEventPtr EventDispatcher::cycleEvent(const std::function<void()>& callback, int delay)
@@ -93,9 +99,11 @@ ScheduledEventPtr EventDispatcher::cycleEvent(const std::function<void()>& callb
 
     assert(delay > 0);
 
-    const auto& thread = getThreadTask();
-    std::scoped_lock lock(thread->mutex);
-    return thread->scheduledEventList.emplace_back(std::make_shared<ScheduledEvent>(callback, delay, 0));
+    const auto& event = std::make_shared<ScheduledEvent>(callback, delay, 0);
+    event->m_dispatcher = this;
+
+    getThreadTask()->scheduledEventList.push(event);
+    return event;
 }
 
 EventPtr EventDispatcher::addEvent(const std::function<void()>& callback)
@@ -108,18 +116,16 @@ EventPtr EventDispatcher::addEvent(const std::function<void()>& callback)
         return std::make_shared<Event>(nullptr);
     }
 
-    const auto& thread = getThreadTask();
-    std::scoped_lock lock(thread->mutex);
-    return thread->events.emplace_back(std::make_shared<Event>(callback));
+    const auto& event = std::make_shared<Event>(callback);
+    getThreadTask()->events.push(event);
+    return event;
 }
 
 void EventDispatcher::deferEvent(const std::function<void()>& callback) {
     if (m_disabled)
         return;
 
-    const auto& thread = getThreadTask();
-    std::scoped_lock lock(thread->mutex);
-    thread->deferEvents.emplace_back(callback);
+    getThreadTask()->deferEvents.push(callback);
 }
 
 void EventDispatcher::executeEvents() {
@@ -140,11 +146,9 @@ void EventDispatcher::executeDeferEvents() {
         m_deferEventList.clear();
 
         for (const auto& thread : m_threads) {
-            std::scoped_lock lock(thread->mutex);
-            if (!thread->deferEvents.empty()) {
-                m_deferEventList.insert(m_deferEventList.end(), make_move_iterator(thread->deferEvents.begin()), make_move_iterator(thread->deferEvents.end()));
-                thread->deferEvents.clear();
-            }
+            thread->deferEvents.consume([this](std::function<void()>&& callback) {
+                m_deferEventList.emplace_back(std::move(callback));
+            });
         }
     } while (!m_deferEventList.empty());
 }
@@ -152,36 +156,155 @@ void EventDispatcher::executeDeferEvents() {
 void EventDispatcher::executeScheduledEvents() {
     auto& threadScheduledTasks = getThreadTask()->scheduledEventList;
 
-    auto it = m_scheduledEventList.begin();
-    while (it != m_scheduledEventList.end()) {
-        const auto& scheduledEvent = *it;
-        if (scheduledEvent->remainingTicks() > 0)
+    const ticks_t now = g_clock.millis();
+    if (m_wheelTicks == 0)
+        m_wheelTicks = now;
+
+    for (; m_wheelTicks <= now; ++m_wheelTicks) {
+        // a whole turn of the previous level was done, bring the next slots down
+        for (uint8_t level = 1; level <= WHEEL_LEVELS; ++level) {
+            if ((m_wheelTicks >> ((level - 1) * WHEEL_BITS)) & WHEEL_MASK)
+                break;
+
+            if (level == WHEEL_LEVELS)
+                cascadeSlot(m_wheelOverflow);
+            else
+                cascadeSlot(m_wheel[level][(m_wheelTicks >> (level * WHEEL_BITS)) & WHEEL_MASK]);
+        }
+
+        auto& slot = m_wheel[0][m_wheelTicks & WHEEL_MASK];
+        if (slot.empty())
+            continue;
+
+        m_dueEvents.swap(slot);
+        for (const auto& scheduledEvent : m_dueEvents)
+            scheduledEvent->m_slot = nullptr;
+
+        // keep the order in which events with the same ticks were scheduled
+        if (m_dueEvents.size() > 1) {
+            std::sort(m_dueEvents.begin(), m_dueEvents.end(), [](const ScheduledEventPtr& a, const ScheduledEventPtr& b) {
+                return a->m_sequence < b->m_sequence;
+            });
+        }
+
+        for (const auto& scheduledEvent : m_dueEvents) {
+            // canceled by another event of this slot
+            if (scheduledEvent->isCanceled())
+                continue;
+
+            // postponed after being scheduled
+            if (scheduledEvent->m_ticks > m_wheelTicks) {
+                insertScheduledEvent(scheduledEvent);
+                continue;
+            }
+
+            scheduledEvent->execute();
+
+            if (scheduledEvent->nextCycle())
+                threadScheduledTasks.push(scheduledEvent);
+        }
+
+        m_dueEvents.clear();
+    }
+}
+
+void EventDispatcher::insertScheduledEvent(const ScheduledEventPtr& event)
+{
+    if (m_wheelTicks == 0)
+        m_wheelTicks = g_clock.millis();
+
+    const ticks_t ticks = std::max<ticks_t>(event->m_ticks, m_wheelTicks);
+    const ticks_t delta = ticks - m_wheelTicks;
+
+    WheelSlot* slot = &m_wheelOverflow;
+    for (uint8_t level = 0; level < WHEEL_LEVELS; ++level) {
+        if (delta < (static_cast<ticks_t>(1) << ((level + 1) * WHEEL_BITS))) {
+            slot = &m_wheel[level][(ticks >> (level * WHEEL_BITS)) & WHEEL_MASK];
             break;
+        }
+    }
 
-        scheduledEvent->execute();
+    event->m_slot = slot;
+    event->m_slotIndex = slot->size();
+    slot->emplace_back(event);
+}
 
-        if (scheduledEvent->nextCycle())
-            threadScheduledTasks.emplace_back(scheduledEvent);
+void EventDispatcher::cascadeSlot(WheelSlot& slot)
+{
+    if (slot.empty())
+        return;
+
+    WheelSlot events;
+    events.swap(slot);
+    for (const auto& event : events)
+        insertScheduledEvent(event);
 
-        ++it;
+    // give the memory back to the slot, it will be filled again on the next turn
+    if (slot.empty()) {
+        events.clear();
+        slot.swap(events);
     }
+}
 
-    if (it != m_scheduledEventList.begin()) {
-        m_scheduledEventList.erase(m_scheduledEventList.begin(), it);
+void EventDispatcher::unlinkScheduledEvent(ScheduledEvent* event)
+{
+    // the wheel is only touched by the thread polling this dispatcher,
+    // events canceled elsewhere are handed to it to be unlinked there.
+    if (m_pollThreadId != getThreadId()) {
+        if (!m_disabled)
+            getThreadTask()->scheduledEventList.push(event->static_self_cast<ScheduledEvent>());
+        return;
     }
+
+    if (!event->m_slot)
+        return;
+
+    auto& slot = *event->m_slot;
+    const uint32_t index = event->m_slotIndex;
+    const auto self = std::move(slot[index]);
+
+    if (index + 1 != slot.size()) {
+        slot[index] = std::move(slot.back());
+        slot[index]->m_slotIndex = index;
+    }
+
+    slot.pop_back();
+    event->m_slot = nullptr;
+}
+
+void EventDispatcher::clearScheduledEvents()
+{
+    const auto clearSlot = [](WheelSlot& slot) {
+        for (const auto& event : slot)
+            event->m_slot = nullptr;
+        slot.clear();
+    };
+
+    for (auto& level : m_wheel) {
+        for (auto& slot : level)
+            clearSlot(slot);
+    }
+
+    clearSlot(m_wheelOverflow);
+    clearSlot(m_dueEvents);
 }
 
 void EventDispatcher::mergeEvents() {
     for (const auto& thread : m_threads) {
-        std::scoped_lock lock(thread->mutex);
-        if (!thread->events.empty()) {
-            m_eventList.insert(m_eventList.end(), make_move_iterator(thread->events.begin()), make_move_iterator(thread->events.end()));
-            thread->events.clear();
-        }
+        thread->events.consume([this](EventPtr&& event) {
+            m_eventList.emplace_back(std::move(event));
+        });
 
-        if (!thread->scheduledEventList.empty()) {
-            m_scheduledEventList.insert(make_move_iterator(thread->scheduledEventList.begin()), make_move_iterator(thread->scheduledEventList.end()));
-            thread->scheduledEventList.clear();
-        }
+        thread->scheduledEventList.consume([this](ScheduledEventPtr&& event) {
+            // restarted while still scheduled or canceled by another thread
+            if (event->m_slot)
+                unlinkScheduledEvent(event.get());
+
+            if (event->isCanceled())
+                return;
+
+            event->m_sequence = ++m_lastSequence;
+            insertScheduledEvent(event);
+        });
     }
-}
\ No newline at end of file
+}
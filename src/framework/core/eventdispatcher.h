@@ -50,46 +50,127 @@ public:
         static std::atomic_int16_t lastId = -1;
         thread_local static int16_t id = -1;
 
-        if (id == -1) {
-            lastId.fetch_add(1);
-            id = lastId.load();
-        }
+        // each id owns a ThreadTask, whose rings take a single producer
+        if (id == -1)
+            id = lastId.fetch_add(1) + 1;
 
         return id;
     };
 
 private:
+    friend class ScheduledEvent;
+
+    // Scheduled events are kept in a hierarchical timing wheel: WHEEL_LEVELS levels of
+    // WHEEL_SLOTS slots, level 0 has one slot per millisecond and each slot of level N
+    // covers a whole turn of level N - 1. Slots of the upper levels are cascaded down as
+    // the wheel turns, so insert, cancel and expiry are O(1) regardless of pending events.
+    static constexpr uint8_t WHEEL_BITS = 6;
+    static constexpr uint8_t WHEEL_LEVELS = 4;
+    static constexpr uint32_t WHEEL_SLOTS = 1 << WHEEL_BITS;
+    static constexpr uint32_t WHEEL_MASK = WHEEL_SLOTS - 1;
+
+    using WheelSlot = std::vector<ScheduledEventPtr>;
+
     inline void mergeEvents();
     inline void executeEvents();
     inline void executeDeferEvents();
     inline void executeScheduledEvents();
 
+    void insertScheduledEvent(const ScheduledEventPtr& event);
+    void cascadeSlot(WheelSlot& slot);
+    void unlinkScheduledEvent(ScheduledEvent* event);
+    void clearScheduledEvents();
+
     const auto& getThreadTask() const {
-        return m_threads[getThreadId()];
+        const auto id = getThreadId();
+        assert(id < static_cast<int16_t>(m_threads.size()));
+        return m_threads[id];
     }
 
     size_t m_pollEventsSize{};
     bool m_disabled{ false };
 
-    // Thread Events
-    struct ThreadTask
+    // Bounded ring buffer written only by its owner thread and read only by the
+    // thread polling the dispatcher, so neither side has to lock. When the ring
+    // is full, items go to a locked overflow list until the poller drains it.
+    // Threads taking turns to poll must serialize their polls themselves.
+    template<typename T, size_t Capacity = 1024>
+    class ThreadQueue
     {
-        ThreadTask() {
-            events.reserve(2000);
-            scheduledEventList.reserve(2000);
+    public:
+        static_assert((Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+        void push(T value) {
+            const size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (!m_overflowed.load(std::memory_order_relaxed) && tail - m_head.load(std::memory_order_acquire) < Capacity) {
+                m_buffer[tail & (Capacity - 1)] = std::move(value);
+                m_tail.store(tail + 1, std::memory_order_release);
+                return;
+            }
+
+            std::scoped_lock lock(m_overflowMutex);
+            m_overflow.emplace_back(std::move(value));
+            m_overflowed.store(true, std::memory_order_release);
+        }
+
+        template<typename F>
+        void consume(F&& f) {
+            consumeBuffer(f);
+
+            if (m_overflowed.load(std::memory_order_acquire)) {
+                std::scoped_lock lock(m_overflowMutex);
+                // the owner filled the ring before overflowing, keep the order
+                consumeBuffer(f);
+                for (auto& value : m_overflow)
+                    f(std::move(value));
+                m_overflow.clear();
+                m_overflowed.store(false, std::memory_order_release);
+            }
         }
 
-        std::vector<EventPtr> events;
-        std::vector<Event> deferEvents;
-        std::vector<ScheduledEventPtr> scheduledEventList;
-        std::mutex mutex;
+        void clear() { consume([](T&&) {}); }
+
+    private:
+        template<typename F>
+        void consumeBuffer(F& f) {
+            size_t head = m_head.load(std::memory_order_relaxed);
+            const size_t tail = m_tail.load(std::memory_order_acquire);
+            for (; head != tail; ++head) {
+                auto& value = m_buffer[head & (Capacity - 1)];
+                f(std::move(value));
+                value = T{};
+            }
+            m_head.store(head, std::memory_order_release);
+        }
+
+        std::unique_ptr<T[]> m_buffer{ std::make_unique<T[]>(Capacity) };
+        alignas(64) std::atomic<size_t> m_head{ 0 };
+        alignas(64) std::atomic<size_t> m_tail{ 0 };
+        alignas(64) std::atomic_bool m_overflowed{ false };
+        std::vector<T> m_overflow;
+        std::mutex m_overflowMutex;
+    };
+
+    // Thread Events
+    struct ThreadTask
+    {
+        ThreadQueue<EventPtr> events;
+        ThreadQueue<std::function<void()>> deferEvents;
+        ThreadQueue<ScheduledEventPtr> scheduledEventList;
     };
     std::vector<std::unique_ptr<ThreadTask>> m_threads;
 
     // Main Events
     std::vector<EventPtr> m_eventList;
     std::vector<Event> m_deferEventList;
-    phmap::btree_multiset<ScheduledEventPtr, ScheduledEvent::Compare> m_scheduledEventList;
+
+    // Scheduled Events
+    std::array<std::array<WheelSlot, WHEEL_SLOTS>, WHEEL_LEVELS> m_wheel;
+    WheelSlot m_wheelOverflow; // events beyond the last level
+    WheelSlot m_dueEvents;
+    ticks_t m_wheelTicks{ 0 }; // next tick to be processed
+    uint64_t m_lastSequence{ 0 };
+    std::atomic_int16_t m_pollThreadId{ -1 };
 };
 
 extern EventDispatcher g_dispatcher, g_textDispatcher, g_mainDispatcher;
@@ -266,6 +266,9 @@ void GraphicalApplication::poll()
     g_particles.poll();
 
     if (!g_window.isVisible()) {
+        // the foreground map thread polls the texts while holding this lock,
+        // it may still be drawing the last frame when the window gets hidden
+        std::scoped_lock l(g_drawPool.get(DrawPoolType::FOREGROUND_MAP)->getMutexPreDraw());
         g_textDispatcher.poll();
     }
 }
@@ -313,6 +316,7 @@ void GraphicalApplication::inputEvent(const InputEvent& event)
 
 void GraphicalApplication::repaintMap() { g_drawPool.get(DrawPoolType::MAP)->repaint(); }
 void GraphicalApplication::repaint() { g_drawPool.get(DrawPoolType::FOREGROUND)->repaint(); }
+uint32_t GraphicalApplication::getDrawCalls(DrawPoolType type) { return g_drawPool.get(type)->getDrawObjectsCount(); }
 bool GraphicalApplication::isLoadingAsyncTexture() { return m_loadingAsyncTexture || (m_drawEvents && m_drawEvents->isLoadingAsyncTexture()); }
 
 void GraphicalApplication::setLoadingAsyncTexture(bool v) {
@@ -85,6 +85,8 @@ public:
 
     void resetTargetFps() { m_graphicFrameCounter.resetTargetFps(); }
 
+    uint32_t getDrawCalls(DrawPoolType type);
+
     bool isOnInputEvent() { return m_onInputEvent; }
     bool mustOptimize() {
 #ifdef NDEBUG
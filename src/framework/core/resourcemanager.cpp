@@ -21,11 +21,13 @@
  */
 
 #include <filesystem>
+#include <numeric>
 
 #include "resourcemanager.h"
 #include "filestream.h"
 
 #include <framework/core/application.h>
+#include <framework/core/asyncdispatcher.h>
 #include <framework/luaengine/luainterface.h>
 #include <framework/platform/platform.h>
 #include <framework/net/protocolhttp.h>
@@ -33,6 +35,14 @@
 
 #include <physfs.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RESOURCES_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define RESOURCES_NEON
+#endif
+
 ResourceManager g_resources;
 
 void ResourceManager::init(const char* argv0)
@@ -307,6 +317,19 @@ bool ResourceManager::deleteFile(const std::string& fileName)
     return PHYSFS_delete(resolvePath(fileName).c_str()) != 0;
 }
 
+bool ResourceManager::renameFile(const std::string& fileName, const std::string& newFileName)
+{
+    // physfs has no rename, createFile places the files in the write directory
+    const char* writeDir = PHYSFS_getWriteDir();
+    if (!writeDir)
+        return false;
+
+    std::error_code ec;
+    std::filesystem::rename(std::filesystem::path(writeDir) / std::filesystem::path(fileName).relative_path(),
+                            std::filesystem::path(writeDir) / std::filesystem::path(newFileName).relative_path(), ec);
+    return !ec;
+}
+
 bool ResourceManager::makeDir(const std::string& directory)
 {
     return PHYSFS_mkdir(directory.c_str());
@@ -449,78 +472,81 @@ ticks_t ResourceManager::getFileTime(const std::string& filename)
     return g_platform.getFileModificationTime(getRealPath(filename));
 }
 
-std::string ResourceManager::encrypt(const std::string& data, const std::string& password)
+namespace
 {
-    const int len = data.length(),
-        plen = password.length();
+    // Decrypting adds a keystream to every byte and encrypting subtracts it:
+    // odd bytes are shifted by (password[j] - i), even ones by (i - password[j]).
+    // Both terms are taken modulo 256, so the keystream repeats every
+    // lcm(password length, 256) bytes and can be built once per password.
+    std::vector<uint8_t> buildKeystream(const std::string_view password)
+    {
+        const size_t plen = std::max<size_t>(password.length(), 1);
+        const size_t length = std::lcm(plen, static_cast<size_t>(256));
 
-    std::ostringstream ss;
-    int j = 0;
-    for (int i = -1; ++i < len;) {
-        int ct = data[i];
-        if (i % 2) {
-            ct = ct - password[j] + i;
-        } else {
-            ct = ct + password[j] - i;
+        std::vector<uint8_t> keystream(length);
+        for (size_t i = 0; i < length; ++i) {
+            const uint8_t key = password.empty() ? 0 : static_cast<uint8_t>(password[i % plen]);
+            keystream[i] = i % 2 ? static_cast<uint8_t>(key - i) : static_cast<uint8_t>(i - key);
         }
-        ss << static_cast<char>(ct);
-        ++j;
 
-        if (j >= plen)
-            j = 0;
+        return keystream;
     }
 
-    return ss.str();
-}
-std::string ResourceManager::decrypt(const std::string& data)
-{
-    const auto& password = std::string(ENCRYPTION_PASSWORD);
-
-    const int len = data.length(),
-        plen = password.length();
+    template<bool Decrypt>
+    void applyKeystream(uint8_t* data, size_t size, size_t offset, const std::vector<uint8_t>& keystream)
+    {
+        size_t k = offset % keystream.size();
+        while (size > 0) {
+            const size_t count = std::min<size_t>(size, keystream.size() - k);
+            const uint8_t* key = keystream.data() + k;
+
+            size_t i = 0;
+#if defined(RESOURCES_SSE2)
+            for (; i + 16 <= count; i += 16) {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                const __m128i kv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key + i));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), Decrypt ? _mm_add_epi8(v, kv) : _mm_sub_epi8(v, kv));
+            }
+#elif defined(RESOURCES_NEON)
+            for (; i + 16 <= count; i += 16) {
+                const uint8x16_t v = vld1q_u8(data + i);
+                const uint8x16_t kv = vld1q_u8(key + i);
+                vst1q_u8(data + i, Decrypt ? vaddq_u8(v, kv) : vsubq_u8(v, kv));
+            }
+#endif
+            for (; i < count; ++i)
+                data[i] = Decrypt ? data[i] + key[i] : data[i] - key[i];
 
-    std::ostringstream ss;
-    int j = 0;
-    for (int i = -1; ++i < len;) {
-        int ct = data[i];
-        if (i % 2) {
-            ct = ct + password[j] - i;
-        } else {
-            ct = ct - password[j] + i;
+            data += count;
+            size -= count;
+            k = 0;
         }
-        ss << static_cast<char>(ct);
-        ++j;
-
-        if (j >= plen)
-            j = 0;
     }
-
-    return ss.str();
 }
 
-uint8_t* ResourceManager::decrypt(uint8_t* data, int32_t size)
+std::string ResourceManager::encrypt(const std::string& data, const std::string& password)
 {
-    const auto& password = std::string(ENCRYPTION_PASSWORD);
-    const int plen = password.length();
-
-    auto* const new_Data = new uint8_t[size];
+    std::string buffer = data;
+    encrypt(reinterpret_cast<uint8_t*>(buffer.data()), buffer.size(), password);
+    return buffer;
+}
 
-    int j = 0;
-    for (int i = -1; ++i < size;) {
-        const int ct = data[i];
-        if (i % 2) {
-            new_Data[i] = ct + password[j] - i;
-        } else {
-            new_Data[i] = ct - password[j] + i;
-        }
-        data[i] = new_Data[i];
-        ++j;
+std::string ResourceManager::decrypt(const std::string& data)
+{
+    std::string buffer = data;
+    decrypt(reinterpret_cast<uint8_t*>(buffer.data()), buffer.size());
+    return buffer;
+}
 
-        if (j >= plen)
-            j = 0;
-    }
+void ResourceManager::encrypt(uint8_t* data, size_t size, const std::string_view password, size_t offset)
+{
+    applyKeystream<false>(data, size, offset, buildKeystream(password));
+}
 
-    return nullptr;
+void ResourceManager::decrypt(uint8_t* data, size_t size, size_t offset)
+{
+    static const auto keystream = buildKeystream(ENCRYPTION_PASSWORD);
+    applyKeystream<true>(data, size, offset, keystream);
 }
 
 void ResourceManager::runEncryption(const std::string& password)
@@ -547,47 +573,163 @@ void ResourceManager::save_string_into_file(const std::string& contents, const s
     datFile.close();
 }
 
-std::string ResourceManager::fileChecksum(const std::string& path) {
-    static stdext::map<std::string, std::string> cache;
+bool ResourceManager::statFile(const std::string& path, int64_t& size, int64_t& modtime)
+{
+    PHYSFS_Stat stat = {};
+    if (!PHYSFS_stat(path.c_str(), &stat) || stat.filetype != PHYSFS_FILETYPE_REGULAR)
+        return false;
+
+    size = stat.filesize;
+    modtime = stat.modtime;
+    return true;
+}
 
-    auto it = cache.find(path);
-    if (it != cache.end())
-        return it->second;
+ResourceManager::FileChecksum ResourceManager::computeFileChecksum(const std::string& path)
+{
+    FileChecksum entry;
+    if (!statFile(path, entry.size, entry.modtime))
+        return {};
 
     PHYSFS_File* file = PHYSFS_openRead(path.c_str());
     if (!file)
-        return "";
+        return {};
 
-    int fileSize = PHYSFS_fileLength(file);
+    const int fileSize = PHYSFS_fileLength(file);
     std::string buffer(fileSize, 0);
-    PHYSFS_readBytes(file, (void*)&buffer[0], fileSize);
+    PHYSFS_readBytes(file, buffer.data(), fileSize);
     PHYSFS_close(file);
 
-    auto checksum = g_crypt.crc32(buffer, false);
-    cache[path] = checksum;
+    entry.checksum = g_crypt.crc32(buffer, false);
+    return entry;
+}
 
-    return checksum;
+void ResourceManager::loadChecksumsManifest()
+{
+    if (m_checksumsManifestLoaded)
+        return;
+
+    m_checksumsManifestLoaded = true;
+
+    const std::string manifest = "/" + std::string(CHECKSUMS_MANIFEST);
+    if (m_writeDir.empty() || !fileExists(manifest))
+        return;
+
+    try {
+        // one file per line: checksum size modtime path
+        std::istringstream in(readFileContents(manifest));
+        std::string line;
+        while (std::getline(in, line)) {
+            std::istringstream fields(line);
+            FileChecksum entry;
+            std::string path;
+            if (!(fields >> entry.checksum >> entry.size >> entry.modtime))
+                continue;
+
+            fields.get();
+            if (std::getline(fields, path) && !path.empty())
+                m_checksums[path] = std::move(entry);
+        }
+    } catch (const std::exception& e) {
+        g_logger.warning(stdext::format("Unable to read checksums manifest: %s", e.what()));
+    }
+}
+
+void ResourceManager::saveChecksumsManifest()
+{
+    if (m_writeDir.empty())
+        return;
+
+    std::ostringstream out;
+    for (const auto& [path, entry] : m_checksums)
+        out << entry.checksum << ' ' << entry.size << ' ' << entry.modtime << ' ' << path << '\n';
+
+    writeFileContents(std::string(CHECKSUMS_MANIFEST), out.str());
+}
+
+std::string ResourceManager::fileChecksum(const std::string& path)
+{
+    loadChecksumsManifest();
+
+    int64_t size, modtime;
+    if (!statFile(path, size, modtime))
+        return "";
+
+    auto& entry = m_checksums[path];
+    if (entry.size != size || entry.modtime != modtime || entry.checksum.empty())
+        entry = computeFileChecksum(path);
+
+    return entry.checksum;
 }
 
 std::unordered_map<std::string, std::string> ResourceManager::filesChecksums()
 {
+    loadChecksumsManifest();
+
     std::unordered_map<std::string, std::string> ret;
-    auto files = listDirectoryFiles("/", true, false, true);
+    std::vector<std::string> pending;
+
+    const auto& manifest = "/" + std::string(CHECKSUMS_MANIFEST);
+    const auto& files = listDirectoryFiles("/", true, false, true);
     for (auto it = files.rbegin(); it != files.rend(); ++it) {
         const auto& filePath = *it;
-        PHYSFS_File* file = PHYSFS_openRead(filePath.c_str());
-        if (!file)
+        if (filePath == manifest || ret.contains(filePath))
+            continue;
+
+        int64_t size, modtime;
+        if (!statFile(filePath, size, modtime))
+            continue;
+
+        const auto entryIt = m_checksums.find(filePath);
+        if (entryIt != m_checksums.end() && entryIt->second.size == size && entryIt->second.modtime == modtime && !entryIt->second.checksum.empty()) {
+            ret[filePath] = entryIt->second.checksum;
             continue;
+        }
+
+        ret[filePath] = "";
+        pending.emplace_back(filePath);
+    }
 
-        int fileSize = PHYSFS_fileLength(file);
-        std::string buffer(fileSize, 0);
-        PHYSFS_readBytes(file, (void*)&buffer[0], fileSize);
-        PHYSFS_close(file);
+    if (!pending.empty()) {
+        // files that changed since the last run are read in parallel, the calling
+        // thread also takes work so it never waits on an idle pool.
+        std::vector<FileChecksum> results(pending.size());
+        std::atomic_size_t next{ 0 };
+
+        const auto& worker = [&] {
+            for (size_t i = next++; i < pending.size(); i = next++)
+                results[i] = computeFileChecksum(pending[i]);
+            return true;
+        };
+
+        std::vector<std::shared_future<bool>> tasks;
+        const size_t threads = std::min<size_t>(g_asyncDispatcher.getNumberOfThreads(), pending.size() - 1);
+        for (size_t i = 0; i < threads; ++i)
+            tasks.emplace_back(g_asyncDispatcher.schedule(worker));
+
+        worker();
+        for (const auto& task : tasks)
+            task.wait();
+
+        for (size_t i = 0; i < pending.size(); ++i) {
+            if (results[i].checksum.empty())
+                ret.erase(pending[i]);
+            else
+                ret[pending[i]] = results[i].checksum;
+            m_checksums[pending[i]] = std::move(results[i]);
+        }
+    }
 
-        auto checksum = g_crypt.crc32(buffer, false);
-        ret[filePath] = checksum;
+    // drop files that no longer exist, so the manifest follows the current tree
+    for (auto it = m_checksums.begin(); it != m_checksums.end();) {
+        if (ret.contains(it->first))
+            ++it;
+        else
+            m_checksums.erase(it++);
     }
 
+    if (!pending.empty())
+        saveChecksumsManifest();
+
     return ret;
 }
 
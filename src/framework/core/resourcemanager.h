@@ -60,6 +60,8 @@ public:
     FileStreamPtr appendFile(const std::string& fileName) const;
     FileStreamPtr createFile(const std::string& fileName) const;
     bool deleteFile(const std::string& fileName);
+    // replaces newFileName, both are relative to the write directory
+    bool renameFile(const std::string& fileName, const std::string& newFileName);
 
     bool makeDir(const std::string& directory);
     std::list<std::string> listDirectoryFiles(const std::string& directoryPath = "", bool fullPath = false, bool raw = false, bool recursive = false);
@@ -81,7 +83,9 @@ public:
 
     std::string encrypt(const std::string& data, const std::string& password);
     std::string decrypt(const std::string& data);
-    static uint8_t* decrypt(uint8_t* data, int32_t size);
+    // in place; offset is the position of data inside the file, so a stream can be handled in chunks
+    static void encrypt(uint8_t* data, size_t size, const std::string_view password, size_t offset = 0);
+    static void decrypt(uint8_t* data, size_t size, size_t offset = 0);
     void runEncryption(const std::string& password);
     void save_string_into_file(const std::string& contents, const std::string& name);
 
@@ -100,10 +104,29 @@ protected:
     std::vector<std::string> discoverPath(const std::filesystem::path& path, bool filenameOnly, bool recursive);
 
 private:
+    // checksums are kept with the size and modification time they were taken at,
+    // and persisted in the write dir so unchanged files aren't read again by the updater.
+    struct FileChecksum
+    {
+        int64_t size{ -1 };
+        int64_t modtime{ -1 };
+        std::string checksum;
+    };
+
+    static constexpr std::string_view CHECKSUMS_MANIFEST = "checksums.manifest";
+
+    static FileChecksum computeFileChecksum(const std::string& path);
+    static bool statFile(const std::string& path, int64_t& size, int64_t& modtime);
+    void loadChecksumsManifest();
+    void saveChecksumsManifest();
+
     std::string m_workDir;
     std::string m_writeDir;
     std::filesystem::path m_binaryPath;
     std::deque<std::string> m_searchPaths;
+
+    stdext::map<std::string, FileChecksum> m_checksums;
+    bool m_checksumsManifestLoaded{ false };
 };
 
 extern ResourceManager g_resources;
@@ -21,6 +21,7 @@
  */
 
 #include "scheduledevent.h"
+#include "eventdispatcher.h"
 
 ScheduledEvent::ScheduledEvent(const std::function<void()>& callback, int delay, int maxCycles) : Event(callback),
 m_ticks(g_clock.millis() + delay), m_delay(delay), m_maxCycles(maxCycles) {}
@@ -39,6 +40,13 @@ void ScheduledEvent::execute()
     ++m_cyclesExecuted;
 }
 
+void ScheduledEvent::cancel()
+{
+    Event::cancel();
+    if (m_dispatcher)
+        m_dispatcher->unlinkScheduledEvent(this);
+}
+
 bool ScheduledEvent::nextCycle()
 {
     if (m_callback && !m_canceled && (m_maxCycles == 0 || m_cyclesExecuted < m_maxCycles)) {
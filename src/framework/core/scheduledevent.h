@@ -25,12 +25,15 @@
 #include "clock.h"
 #include "event.h"
 
+class EventDispatcher;
+
  // @bindclass
 class ScheduledEvent : public Event
 {
 public:
     ScheduledEvent(const std::function<void()>& callback, int delay, int maxCycles = 0);
     void execute() override;
+    void cancel() override;
     void postpone() { m_ticks = g_clock.millis() + m_delay; }
     bool nextCycle();
 
@@ -40,17 +43,17 @@ public:
     int cyclesExecuted() { return m_cyclesExecuted; }
     int maxCycles() { return m_maxCycles; }
 
-    struct Compare
-    {
-        bool operator() (const ScheduledEventPtr& a, const ScheduledEventPtr& b) const
-        {
-            return b->ticks() > a->ticks();
-        }
-    };
-
 private:
+    friend class EventDispatcher;
+
     ticks_t m_ticks;
     int m_delay;
     int m_maxCycles;
     int m_cyclesExecuted{ 0 };
+
+    // timing wheel slot of the dispatcher holding this event, see EventDispatcher
+    EventDispatcher* m_dispatcher{ nullptr };
+    std::vector<ScheduledEventPtr>* m_slot{ nullptr };
+    uint32_t m_slotIndex{ 0 };
+    uint64_t m_sequence{ 0 };
 };
@@ -44,6 +44,8 @@ void BitmapFont::load(const OTMLNodePtr& fontNode)
     m_firstGlyph = fontNode->valueAt("first-glyph", 32);
     m_glyphSpacing = fontNode->valueAt("spacing", Size(0));
 
+    clearLayoutCache();
+
     // load font texture
     m_texture = g_textures.getTexture(textureFile, false);
     if (!m_texture)
@@ -96,9 +98,8 @@ void BitmapFont::drawText(const std::string_view text, const Point& startPos, co
 
 void BitmapFont::drawText(const std::string_view text, const Rect& screenCoords, const Color& color, Fw::AlignmentFlag align)
 {
-    Size textBoxSize;
-    const auto& glyphsPositions = calculateGlyphsPositions(text, align, &textBoxSize);
-    for (const auto& [dest, src] : getDrawTextCoords(text, textBoxSize, align, screenCoords, glyphsPositions)) {
+    const auto& layout = getTextLayout(text, align);
+    for (const auto& [dest, src] : getDrawTextCoords(layout->text, layout->textSize, align, screenCoords, layout->glyphsPositions)) {
         g_drawPool.addTexturedRect(dest, m_texture, src, color);
     }
 }
@@ -254,6 +255,39 @@ void BitmapFont::fillTextCoords(const CoordsBufferPtr& coords, const std::string
     }
 }
 
+bool BitmapFont::fillTextCoords(const CoordsBufferPtr& coords, const TextLayout& layout, Fw::AlignmentFlag align, const Rect& screenCoords) const
+{
+    coords->clear();
+
+    // prevent glitches from invalid rects
+    if (!screenCoords.isValid() || !m_texture || layout.glyphsCoords.empty())
+        return true;
+
+    Point offset;
+    if (align & Fw::AlignBottom) {
+        offset.y = screenCoords.height() - layout.textSize.height();
+    } else if (align & Fw::AlignVerticalCenter) {
+        offset.y = (screenCoords.height() - layout.textSize.height()) / 2;
+    }
+
+    if (align & Fw::AlignRight) {
+        offset.x = screenCoords.width() - layout.textSize.width();
+    } else if (align & Fw::AlignHorizontalCenter) {
+        offset.x = (screenCoords.width() - layout.textSize.width()) / 2;
+    }
+
+    // glyphs crossing 0, 0 or the screen coords must be clipped one by one
+    const Rect& bounds = layout.bounds.translated(offset);
+    if (bounds.left() < 0 || bounds.top() < 0 || !screenCoords.contains(bounds.translated(screenCoords.topLeft())))
+        return false;
+
+    offset += screenCoords.topLeft();
+    for (const auto& [dest, src] : layout.glyphsCoords)
+        coords->addRect(dest.translated(offset), src);
+
+    return true;
+}
+
 void BitmapFont::fillTextColorCoords(std::vector<std::pair<Color, CoordsBufferPtr>>& colorCoords, const std::string_view text, 
                         const std::vector<std::pair<int, Color>> textColors,
                         const Size& textBoxSize, Fw::AlignmentFlag align,
@@ -547,3 +581,64 @@ void BitmapFont::updateColors(std::vector<std::pair<int, Color>>* colors, int po
         }
     }
 }
+
+TextLayoutPtr BitmapFont::getTextLayout(const std::string_view text, Fw::AlignmentFlag align, int wrapWidth)
+{
+    size_t hash = stdext::hash<std::string_view>()(text);
+    stdext::hash_union(hash, align);
+    stdext::hash_union(hash, wrapWidth);
+
+    std::scoped_lock l(m_layoutCacheMutex);
+
+    if (const auto it = m_layoutCacheIndex.find(hash); it != m_layoutCacheIndex.end()) {
+        const auto& entry = *it->second;
+        if (entry.align == align && entry.wrapWidth == wrapWidth && entry.source == text) {
+            m_layoutCache.splice(m_layoutCache.begin(), m_layoutCache, it->second);
+            ++m_layoutCacheHits;
+            return entry.layout;
+        }
+
+        // hash collision, the new text takes its place
+        m_layoutCache.erase(it->second);
+        m_layoutCacheIndex.erase(it);
+    }
+
+    ++m_layoutCacheMisses;
+
+    const auto& layout = std::make_shared<TextLayout>();
+    layout->text = wrapWidth > 0 ? wrapText(text, wrapWidth) : std::string(text);
+
+    const int textLength = layout->text.length();
+    const auto& glyphsPositions = calculateGlyphsPositions(layout->text, align, &layout->textSize);
+    layout->glyphsPositions.assign(glyphsPositions.begin(), glyphsPositions.begin() + std::max<int>(textLength, 1));
+
+    for (int i = 0; i < textLength; ++i) {
+        const int glyph = static_cast<uint8_t>(layout->text[i]);
+        if (glyph < 32)
+            continue;
+
+        const Rect glyphScreenCoords(layout->glyphsPositions[i], m_glyphsSize[glyph]);
+        if (!glyphScreenCoords.isValid())
+            continue;
+
+        layout->glyphsCoords.emplace_back(glyphScreenCoords, m_glyphsTextureCoords[glyph]);
+        layout->bounds = layout->bounds.isValid() ? layout->bounds.united(glyphScreenCoords) : glyphScreenCoords;
+    }
+
+    m_layoutCache.emplace_front(LayoutCacheEntry{ hash, std::string(text), align, wrapWidth, layout });
+    m_layoutCacheIndex[hash] = m_layoutCache.begin();
+
+    if (m_layoutCache.size() > LAYOUT_CACHE_SIZE) {
+        m_layoutCacheIndex.erase(m_layoutCache.back().hash);
+        m_layoutCache.pop_back();
+    }
+
+    return layout;
+}
+
+void BitmapFont::clearLayoutCache()
+{
+    std::scoped_lock l(m_layoutCacheMutex);
+    m_layoutCache.clear();
+    m_layoutCacheIndex.clear();
+}
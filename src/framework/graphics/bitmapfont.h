@@ -26,8 +26,22 @@
 
 #include <framework/otml/declarations.h>
 
+#include <list>
 #include <utility>
 
+// Glyphs of a text laid out from the top left of its text box,
+// shared by every text drawn with the same font, alignment and wrap width.
+struct TextLayout
+{
+    std::string text; // already wrapped
+    Size textSize;
+    Rect bounds; // area covered by the glyphs
+    std::vector<Point> glyphsPositions;
+    std::vector<std::pair<Rect, Rect>> glyphsCoords; // screen and texture coords
+};
+
+using TextLayoutPtr = std::shared_ptr<const TextLayout>;
+
 class BitmapFont
 {
 public:
@@ -52,6 +66,11 @@ public:
                         const Size& textBoxSize, Fw::AlignmentFlag align,
                         const Rect& screenCoords, const std::vector<Point>& glyphsPositions) const;
 
+    /// Fill coords with the prebuilt glyphs of a layout, returns false when
+    /// the glyphs would need to be clipped by screenCoords
+    bool fillTextCoords(const CoordsBufferPtr& coords, const TextLayout& layout,
+                        Fw::AlignmentFlag align, const Rect& screenCoords) const;
+
     void fillTextColorCoords(std::vector<std::pair<Color, CoordsBufferPtr>>& colorCoords, const std::string_view text, 
                         const std::vector<std::pair<int, Color>> textColors,
                         const Size& textBoxSize, Fw::AlignmentFlag align,
@@ -68,6 +87,13 @@ public:
 
     std::string wrapText(const std::string_view text, int maxWidth, std::vector<std::pair<int, Color>>* colors = nullptr);
 
+    /// Cached layout of the text, wrapped to wrapWidth when greater than 0
+    TextLayoutPtr getTextLayout(const std::string_view text, Fw::AlignmentFlag align, int wrapWidth = 0);
+    void clearLayoutCache();
+
+    uint32_t getLayoutCacheHits() const { return m_layoutCacheHits; }
+    uint32_t getLayoutCacheMisses() const { return m_layoutCacheMisses; }
+
     const std::string& getName() { return m_name; }
     int getGlyphHeight() const { return m_glyphHeight; }
     const Rect* getGlyphsTextureCoords() { return m_glyphsTextureCoords; }
@@ -81,6 +107,17 @@ private:
     void calculateGlyphsWidthsAutomatically(const ImagePtr& image, const Size& glyphSize);
     void updateColors(std::vector<std::pair<int, Color>>* colors, int pos, int newTextLen);
 
+    static constexpr size_t LAYOUT_CACHE_SIZE = 1024;
+
+    struct LayoutCacheEntry
+    {
+        size_t hash;
+        std::string source;
+        Fw::AlignmentFlag align;
+        int wrapWidth;
+        TextLayoutPtr layout;
+    };
+
     std::string m_name;
     int m_glyphHeight{ 0 };
     int m_firstGlyph{ 0 };
@@ -89,4 +126,11 @@ private:
     TexturePtr m_texture;
     Rect m_glyphsTextureCoords[256];
     Size m_glyphsSize[256];
+
+    // least recently used layouts are at the back
+    std::list<LayoutCacheEntry> m_layoutCache;
+    stdext::map<size_t, std::list<LayoutCacheEntry>::iterator> m_layoutCacheIndex;
+    std::mutex m_layoutCacheMutex;
+    std::atomic_uint32_t m_layoutCacheHits{ 0 };
+    std::atomic_uint32_t m_layoutCacheMisses{ 0 };
 };
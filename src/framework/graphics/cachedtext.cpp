@@ -28,12 +28,13 @@ CachedText::CachedText() : m_align(Fw::AlignCenter), m_coordsBuffer(std::make_sh
 
 void CachedText::draw(const Rect& rect, const Color& color)
 {
-    if (!m_font)
+    if (!m_font || !m_layout)
         return;
 
     if (m_textScreenCoords != rect) {
         m_textScreenCoords = rect;
-        m_font->fillTextCoords(m_coordsBuffer, m_text, m_textSize, m_align, rect, m_glyphsPositions);
+        if (!m_font->fillTextCoords(m_coordsBuffer, *m_layout, m_align, rect))
+            m_font->fillTextCoords(m_coordsBuffer, m_layout->text, m_textSize, m_align, rect, m_layout->glyphsPositions);
     }
 
     g_drawPool.addTexturedCoordsBuffer(m_font->getTexture(), m_coordsBuffer, color);
@@ -42,18 +43,20 @@ void CachedText::draw(const Rect& rect, const Color& color)
 void CachedText::update()
 {
     if (m_font) {
-        m_glyphsPositions = m_font->calculateGlyphsPositions(m_text, m_align, &m_textSize);
-    }
+        m_layout = m_font->getTextLayout(m_text, m_align, m_wrapWidth);
+        m_textSize = m_layout->textSize;
+    } else
+        m_layout = nullptr;
 
     m_textScreenCoords = {};
 }
 
 void CachedText::wrapText(int maxWidth)
 {
-    if (!m_font)
+    if (m_wrapWidth == maxWidth)
         return;
 
-    m_text = m_font->wrapText(m_text, maxWidth);
+    m_wrapWidth = maxWidth;
     update();
 }
 
@@ -65,12 +68,13 @@ void CachedText::setFont(const BitmapFontPtr& font)
     m_font = font;
     update();
 }
-void CachedText::setText(const std::string_view text)
+void CachedText::setText(const std::string_view text, int wrapWidth)
 {
-    if (m_text == text)
+    if (m_text == text && m_wrapWidth == wrapWidth)
         return;
 
     m_text = text;
+    m_wrapWidth = wrapWidth;
     update();
 }
 void CachedText::setAlign(const Fw::AlignmentFlag align)
@@ -22,7 +22,7 @@
 
 #pragma once
 
-#include "declarations.h"
+#include "bitmapfont.h"
 
 class CachedText
 {
@@ -33,11 +33,12 @@ public:
 
     void wrapText(int maxWidth);
     void setFont(const BitmapFontPtr& font);
-    void setText(const std::string_view text);
+    // the text is laid out once for the given wrap width, 0 doesn't wrap
+    void setText(const std::string_view text, int wrapWidth = 0);
     void setAlign(const Fw::AlignmentFlag align);
 
     Size getTextSize() const { return m_textSize; }
-    std::string getText() const { return m_text; }
+    std::string getText() const { return m_layout ? m_layout->text : m_text; }
     bool hasText() const { return !m_text.empty(); }
     BitmapFontPtr getFont() const { return m_font; }
     Fw::AlignmentFlag getAlign() const { return m_align; }
@@ -45,14 +46,14 @@ public:
 private:
     void update();
 
-    std::vector<std::pair<Rect, Rect>> m_TextureCoords;
-    std::vector<Point> m_glyphsPositions;
+    TextLayoutPtr m_layout;
 
     std::string m_text;
     Size m_textSize;
     Rect m_textScreenCoords;
     BitmapFontPtr m_font;
     Fw::AlignmentFlag m_align;
+    int m_wrapWidth{ 0 };
 
     CoordsBufferPtr m_coordsBuffer;
 };
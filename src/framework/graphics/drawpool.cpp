@@ -52,8 +52,16 @@ DrawPool* DrawPool::create(const DrawPoolType type)
 void DrawPool::add(const Color& color, const TexturePtr& texture, DrawPool::DrawMethod&& method,
                    DrawMode drawMode, const DrawConductor& conductor, const CoordsBufferPtr& coordsBuffer)
 {
+    if (m_recording)
+        record(color, texture, method, drawMode, conductor, coordsBuffer);
+
     updateHash(method, texture, color);
+    addObject(color, texture, std::move(method), drawMode, conductor, coordsBuffer);
+}
 
+void DrawPool::addObject(const Color& color, const TexturePtr& texture, DrawPool::DrawMethod&& method,
+                         DrawMode drawMode, const DrawConductor& conductor, const CoordsBufferPtr& coordsBuffer)
+{
     uint8_t order = conductor.order;
     if (m_type == DrawPoolType::FOREGROUND)
         order = DrawOrder::FIRST;
@@ -101,6 +109,79 @@ void DrawPool::add(const Color& color, const TexturePtr& texture, DrawPool::Draw
     resetOnlyOnceParameters();
 }
 
+void DrawPool::beginRecording(RetainedCommands& commands, const Point& origin)
+{
+    commands.commands.clear();
+    commands.hash = 0;
+
+    m_recording = &commands;
+    m_recordingOrigin = origin;
+    m_recordingStateHash = getStateHash();
+}
+
+bool DrawPool::endRecording()
+{
+    // the recording was stopped by a draw that cannot be replayed
+    if (!m_recording)
+        return false;
+
+    auto& recording = *m_recording;
+    m_recording = nullptr;
+
+    for (const auto& command : recording.commands) {
+        stdext::hash_union(recording.hash, command.dest.hash());
+        stdext::hash_union(recording.hash, command.src.hash());
+    }
+
+    return true;
+}
+
+void DrawPool::record(const Color& color, const TexturePtr& texture, const DrawPool::DrawMethod& method,
+                      DrawMode drawMode, const DrawConductor& conductor, const CoordsBufferPtr& coordsBuffer)
+{
+    // only plain rects added with the state the recording began with can be replayed under the live state,
+    // anything else stops it; the draws are added as usual either way, so nothing has to be flushed
+    if (method.type == DrawMethodType::RECT && !coordsBuffer && m_onlyOnceStateFlag == 0 && !m_state.shaderProgram
+        && getStateHash() == m_recordingStateHash) {
+        m_recording->commands.emplace_back(RetainedCommands::Command{
+            color, texture, method.dest.translated(-m_recordingOrigin.x, -m_recordingOrigin.y), method.src, drawMode, conductor
+        });
+    } else
+        m_recording = nullptr;
+}
+
+void DrawPool::addRetained(const RetainedCommands& commands, const Point& origin)
+{
+    if (m_onlyOnceStateFlag > 0) { // taken by the first command only, as if drawn live
+        for (const auto& command : commands.commands)
+            add(command.color, command.texture.lock(), DrawMethod{ .type = DrawMethodType::RECT, .dest = command.dest.translated(origin), .src = command.src }, command.drawMode, command.conductor);
+        return;
+    }
+
+    // the rects were hashed when recorded, only the state and the origin can change
+    const size_t stateHash = getStateHash();
+    if (hasFrameBuffer()) {
+        stdext::hash_union(m_status.second, commands.hash);
+        stdext::hash_union(m_status.second, origin.hash());
+    }
+
+    for (const auto& command : commands.commands) {
+        const auto& texture = command.texture.lock();
+        m_state.hash = stateHash;
+
+        if (command.color != Color::white)
+            stdext::hash_union(m_state.hash, command.color.hash());
+
+        if (texture)
+            stdext::hash_union(m_state.hash, texture->hash());
+
+        if (hasFrameBuffer() && m_state.hash)
+            stdext::hash_union(m_status.second, m_state.hash);
+
+        addObject(command.color, texture, DrawMethod{ .type = DrawMethodType::RECT, .dest = command.dest.translated(origin), .src = command.src }, command.drawMode, command.conductor, nullptr);
+    }
+}
+
 void DrawPool::addCoords(CoordsBuffer* buffer, const DrawMethod& method, DrawMode drawMode)
 {
     if (method.type == DrawMethodType::BOUNDING_RECT) {
@@ -124,28 +205,7 @@ void DrawPool::addCoords(CoordsBuffer* buffer, const DrawMethod& method, DrawMod
 
 void DrawPool::updateHash(const DrawPool::DrawMethod& method, const TexturePtr& texture, const Color& color) {
     { // State Hash
-        m_state.hash = 0;
-
-        if (m_bindedFramebuffers)
-            stdext::hash_combine(m_state.hash, m_lastFramebufferId);
-
-        if (m_state.blendEquation != BlendEquation::ADD)
-            stdext::hash_combine(m_state.hash, m_state.blendEquation);
-
-        if (m_state.compositionMode != CompositionMode::NORMAL)
-            stdext::hash_combine(m_state.hash, m_state.compositionMode);
-
-        if (m_state.opacity < 1.f)
-            stdext::hash_combine(m_state.hash, m_state.opacity);
-
-        if (m_state.clipRect.isValid())
-            stdext::hash_union(m_state.hash, m_state.clipRect.hash());
-
-        if (m_state.shaderProgram)
-            stdext::hash_union(m_state.hash, m_state.shaderProgram->hash());
-
-        if (m_state.transformMatrix != DEFAULT_MATRIX3)
-            stdext::hash_union(m_state.hash, m_state.transformMatrix.hash());
+        m_state.hash = getStateHash();
 
         if (color != Color::white)
             stdext::hash_union(m_state.hash, color.hash());
@@ -171,6 +231,34 @@ void DrawPool::updateHash(const DrawPool::DrawMethod& method, const TexturePtr&
     }
 }
 
+size_t DrawPool::getStateHash() const
+{
+    size_t hash = 0;
+
+    if (m_bindedFramebuffers)
+        stdext::hash_combine(hash, m_lastFramebufferId);
+
+    if (m_state.blendEquation != BlendEquation::ADD)
+        stdext::hash_combine(hash, m_state.blendEquation);
+
+    if (m_state.compositionMode != CompositionMode::NORMAL)
+        stdext::hash_combine(hash, m_state.compositionMode);
+
+    if (m_state.opacity < 1.f)
+        stdext::hash_combine(hash, m_state.opacity);
+
+    if (m_state.clipRect.isValid())
+        stdext::hash_union(hash, m_state.clipRect.hash());
+
+    if (m_state.shaderProgram)
+        stdext::hash_union(hash, m_state.shaderProgram->hash());
+
+    if (m_state.transformMatrix != DEFAULT_MATRIX3)
+        stdext::hash_union(hash, m_state.transformMatrix.hash());
+
+    return hash;
+}
+
 DrawPool::PoolState DrawPool::getState(const TexturePtr& texture, const Color& color)
 {
     return PoolState{
@@ -231,6 +319,7 @@ void DrawPool::resetState()
     m_objectsFlushed.clear();
     m_coords.clear();
     m_parameters.clear();
+    m_recording = nullptr;
 
     m_state = {};
     m_status.second = 0;
@@ -97,9 +97,29 @@ public:
     void onBeforeDraw(std::function<void()>&& f) { m_beforeDraw = std::move(f); }
     void onAfterDraw(std::function<void()>&& f) { m_afterDraw = std::move(f); }
 
+    // number of batches submitted in the last repaint
+    uint32_t getDrawObjectsCount() const { return m_drawObjectsCount; }
+
     std::mutex& getMutex() { return m_mutexDraw; }
     std::mutex& getMutexPreDraw() { return m_mutexPreDraw; }
 
+    // Draws recorded once by an object that adds the same rects every frame; they are kept
+    // by the object and replayed relative to a point, see DrawPoolManager::beginRecording.
+    struct RetainedCommands
+    {
+        struct Command
+        {
+            Color color;
+            std::weak_ptr<Texture> texture; // not kept alive, the owner records again once it changes
+            Rect dest, src;
+            DrawMode drawMode;
+            DrawConductor conductor;
+        };
+
+        std::vector<Command> commands;
+        size_t hash{ 0 };
+    };
+
 protected:
 
     enum class DrawMethodType
@@ -182,6 +202,14 @@ private:
     void add(const Color& color, const TexturePtr& texture, DrawPool::DrawMethod&& method,
              DrawMode drawMode = DrawMode::TRIANGLES, const DrawConductor& conductor = DEFAULT_DRAW_CONDUCTOR,
              const CoordsBufferPtr& coordsBuffer = nullptr);
+    void addObject(const Color& color, const TexturePtr& texture, DrawPool::DrawMethod&& method,
+                   DrawMode drawMode, const DrawConductor& conductor, const CoordsBufferPtr& coordsBuffer);
+
+    void beginRecording(RetainedCommands& commands, const Point& origin);
+    bool endRecording();
+    void record(const Color& color, const TexturePtr& texture, const DrawPool::DrawMethod& method,
+                DrawMode drawMode, const DrawConductor& conductor, const CoordsBufferPtr& coordsBuffer);
+    void addRetained(const RetainedCommands& commands, const Point& origin);
 
     void addAction(const std::function<void()>& action);
     void bindFrameBuffer(const Size& size, const Color& color = Color::white);
@@ -190,6 +218,7 @@ private:
     inline void setFPS(uint16_t fps) { m_refreshDelay = fps; }
 
     void updateHash(const DrawPool::DrawMethod& method, const TexturePtr& texture, const Color& color);
+    size_t getStateHash() const;
     PoolState getState(const TexturePtr& texture, const Color& color);
 
     float getOpacity() const { return m_state.opacity; }
@@ -257,6 +286,8 @@ private:
                 m_objectsDraw.insert(m_objectsDraw.end(), make_move_iterator(objs.begin()), make_move_iterator(objs.end()));
                 objs.clear();
             }
+
+            m_drawObjectsCount = m_objectsDraw.size();
         }
 
         m_objectsFlushed.clear();
@@ -294,6 +325,7 @@ private:
 
     uint16_t m_refreshDelay{ 0 }, m_shaderRefreshDelay{ 0 };
     uint32_t m_onlyOnceStateFlag{ 0 };
+    uint32_t m_drawObjectsCount{ 0 };
     uint_fast64_t m_lastFramebufferId{ 0 };
 
     PoolState m_state, m_oldState;
@@ -312,6 +344,10 @@ private:
     std::vector<DrawObject> m_objectsDraw;
 
     stdext::map<size_t, CoordsBuffer*> m_coords;
+
+    RetainedCommands* m_recording{ nullptr };
+    Point m_recordingOrigin;
+    size_t m_recordingStateHash{ 0 };
     stdext::map<std::string_view, std::any> m_parameters;
 
     float m_scaleFactor{ 1.f };
@@ -54,6 +54,12 @@ public:
     void addBoundingRect(const Rect& dest, const Color& color = Color::white, uint16_t innerLineWidth = 1, const DrawConductor& condutor = DEFAULT_DRAW_CONDUCTOR) const;
     void addAction(const std::function<void()>& action) const { getCurrentPool()->addAction(action); }
 
+    // draws added until endRecording are also kept in commands, relative to origin, to be replayed
+    // with addRetained; endRecording returns false if one of them could not be kept.
+    void beginRecording(DrawPool::RetainedCommands& commands, const Point& origin) const { getCurrentPool()->beginRecording(commands, origin); }
+    bool endRecording() const { return getCurrentPool()->endRecording(); }
+    void addRetained(const DrawPool::RetainedCommands& commands, const Point& origin) const { getCurrentPool()->addRetained(commands, origin); }
+
     void bindFrameBuffer(const Size& size, const Color& color = Color::white) const { getCurrentPool()->bindFrameBuffer(size, color); }
     void releaseFrameBuffer(const Rect& dest) const { getCurrentPool()->releaseFrameBuffer(dest); };
 
@@ -62,6 +68,7 @@ public:
     void setBlendEquation(BlendEquation equation, bool onlyOnce = false) const { getCurrentPool()->setBlendEquation(equation, onlyOnce); }
     void setCompositionMode(const CompositionMode mode, bool onlyOnce = false) const { getCurrentPool()->setCompositionMode(mode, onlyOnce); }
 
+    PainterShaderProgram* getShaderProgram() const { return getCurrentPool()->m_state.shaderProgram; }
     bool shaderNeedFramebuffer() const { return getCurrentPool()->m_state.shaderProgram && getCurrentPool()->m_state.shaderProgram->useFramebuffer(); }
     void setShaderProgram(const PainterShaderProgramPtr& shaderProgram, const std::function<void()>& action) const { getCurrentPool()->setShaderProgram(shaderProgram, false, action); }
     void setShaderProgram(const PainterShaderProgramPtr& shaderProgram, bool onlyOnce = false, const std::function<void()>& action = nullptr) const { getCurrentPool()->setShaderProgram(shaderProgram, onlyOnce, action); }
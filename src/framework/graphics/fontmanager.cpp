@@ -69,6 +69,22 @@ bool FontManager::importFont(const std::string& file)
     }
 }
 
+uint32_t FontManager::getLayoutCacheHits()
+{
+    uint32_t hits = 0;
+    for (const auto& font : m_fonts)
+        hits += font->getLayoutCacheHits();
+    return hits;
+}
+
+uint32_t FontManager::getLayoutCacheMisses()
+{
+    uint32_t misses = 0;
+    for (const auto& font : m_fonts)
+        misses += font->getLayoutCacheMisses();
+    return misses;
+}
+
 bool FontManager::fontExists(const std::string_view fontName)
 {
     for (const auto& font : m_fonts) {
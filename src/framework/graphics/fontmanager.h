@@ -42,6 +42,9 @@ public:
     void setDefaultFont(const BitmapFontPtr& font) { m_defaultFont = font; }
     void setDefaultWidgetFont(const BitmapFontPtr& font) { m_defaultWidgetFont = font; }
 
+    uint32_t getLayoutCacheHits();
+    uint32_t getLayoutCacheMisses();
+
 private:
     std::vector<BitmapFontPtr> m_fonts;
     BitmapFontPtr m_defaultFont;
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "textureatlas.h"
+#include "graphics.h"
+#include "image.h"
+
+class AtlasTexture : public Texture
+{
+public:
+    AtlasTexture(const Size& size) { setupSize(size); }
+
+    Texture* create() override
+    {
+        if (m_id == 0) {
+            createTexture();
+            bind();
+
+            // starts transparent, so padding and free slots never bleed into the regions
+            std::vector<uint8_t> pixels(m_size.area() * 4, 0);
+            setupPixels(0, m_size, pixels.data(), 4);
+            setupWrap();
+            setupFilters();
+        }
+
+        // create() runs on every bind, only lock when there is something to upload
+        if (!m_hasPendingUploads.load(std::memory_order_acquire))
+            return this;
+
+        std::scoped_lock l(m_mutex);
+        bind();
+
+        std::vector<uint8_t> clearPixels;
+        for (const auto& [rect, image] : m_pendingUploads) {
+            if (image) {
+                glTexSubImage2D(GL_TEXTURE_2D, 0, rect.x(), rect.y(), rect.width(), rect.height(), GL_RGBA, GL_UNSIGNED_BYTE, image->getPixelData());
+                continue;
+            }
+
+            clearPixels.resize(std::max<size_t>(clearPixels.size(), rect.size().area() * 4), 0);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, rect.x(), rect.y(), rect.width(), rect.height(), GL_RGBA, GL_UNSIGNED_BYTE, clearPixels.data());
+        }
+
+        m_pendingUploads.clear();
+        m_hasPendingUploads.store(false, std::memory_order_release);
+
+        return this;
+    }
+
+    void upload(const Point& pos, const ImagePtr& image)
+    {
+        std::scoped_lock l(m_mutex);
+        m_pendingUploads.emplace_back(Rect(pos, image->getSize()), image);
+        m_hasPendingUploads.store(true, std::memory_order_release);
+    }
+
+    // makes a released slot transparent again, before it can be reused
+    void clear(const Rect& rect)
+    {
+        std::scoped_lock l(m_mutex);
+        m_pendingUploads.emplace_back(rect, nullptr);
+        m_hasPendingUploads.store(true, std::memory_order_release);
+    }
+
+private:
+    std::vector<std::pair<Rect, ImagePtr>> m_pendingUploads; // a null image clears the rect
+    std::atomic_bool m_hasPendingUploads{ false };
+    std::mutex m_mutex;
+};
+
+TexturePtr TextureAtlas::add(const ImagePtr& image, Rect& rect)
+{
+    if (image->getBpp() != 4)
+        return nullptr;
+
+    const Size& imageSize = image->getSize();
+    if (imageSize.width() > m_maxRegionSize || imageSize.height() > m_maxRegionSize)
+        return nullptr;
+
+    const Size size = imageSize + Size(PADDING * 2);
+
+    std::scoped_lock l(m_mutex);
+
+    Page* page = nullptr;
+    Point pos;
+    for (auto& p : m_pages) {
+        if (allocate(p, size, pos)) {
+            page = &p;
+            break;
+        }
+    }
+
+    if (!page) {
+        const int pageSize = std::min<int>(m_pageSize, g_graphics.getMaxTextureSize());
+        if (pageSize < size.width() || pageSize < size.height())
+            return nullptr;
+
+        page = &m_pages.emplace_back();
+        page->texture = std::make_shared<AtlasTexture>(Size(pageSize));
+        if (!allocate(*page, size, pos))
+            return nullptr;
+    }
+
+    ++page->regions;
+
+    pos += Point(PADDING);
+    static_cast<AtlasTexture*>(page->texture.get())->upload(pos, image);
+
+    rect = Rect(pos, imageSize);
+    return page->texture;
+}
+
+bool TextureAtlas::allocate(Page& page, const Size& size, Point& pos)
+{
+    const Size& pageSize = page.texture->getSize();
+
+    for (auto& shelf : page.shelves) {
+        if (shelf.height != size.height())
+            continue;
+
+        // reuse space released by previous regions
+        for (auto it = shelf.freeSlots.begin(); it != shelf.freeSlots.end(); ++it) {
+            auto& [x, width] = *it;
+            if (width < size.width())
+                continue;
+
+            pos = { x, shelf.y };
+            x += size.width();
+            width -= size.width();
+            if (width == 0)
+                shelf.freeSlots.erase(it);
+            return true;
+        }
+
+        if (shelf.nextX + size.width() <= pageSize.width()) {
+            pos = { shelf.nextX, shelf.y };
+            shelf.nextX += size.width();
+            return true;
+        }
+    }
+
+    if (page.nextY + size.height() > pageSize.height())
+        return false;
+
+    auto& shelf = page.shelves.emplace_back();
+    shelf.y = page.nextY;
+    shelf.height = size.height();
+    shelf.nextX = size.width();
+    page.nextY += size.height();
+
+    pos = { 0, shelf.y };
+    return true;
+}
+
+void TextureAtlas::remove(const TexturePtr& texture, const Rect& rect)
+{
+    std::scoped_lock l(m_mutex);
+
+    const auto pageIt = std::find_if(m_pages.begin(), m_pages.end(), [&](const Page& page) { return page.texture == texture; });
+    if (pageIt == m_pages.end())
+        return;
+
+    auto& page = *pageIt;
+
+    const int x = rect.x() - PADDING;
+    const int y = rect.y() - PADDING;
+    const int width = rect.width() + PADDING * 2;
+
+    static_cast<AtlasTexture*>(page.texture.get())->clear(Rect(x, y, width, rect.height() + PADDING * 2));
+
+    if (--page.regions == 0) {
+        // nothing left in this page, so the whole area can be packed again
+        page.shelves.clear();
+        page.nextY = 0;
+        return;
+    }
+
+    for (auto& shelf : page.shelves) {
+        if (shelf.y != y)
+            continue;
+
+        if (x + width == shelf.nextX) {
+            shelf.nextX = x;
+
+            // the last slot may now be adjacent to the end of the shelf
+            const auto slotIt = std::find_if(shelf.freeSlots.begin(), shelf.freeSlots.end(), [&](const auto& slot) { return slot.first + slot.second == shelf.nextX; });
+            if (slotIt != shelf.freeSlots.end()) {
+                shelf.nextX = slotIt->first;
+                shelf.freeSlots.erase(slotIt);
+            }
+        } else {
+            shelf.freeSlots.emplace_back(x, width);
+        }
+        break;
+    }
+}
+
+void TextureAtlas::clear()
+{
+    std::scoped_lock l(m_mutex);
+    m_pages.clear();
+}
+
+uint32_t TextureAtlas::getPagesCount()
+{
+    std::scoped_lock l(m_mutex);
+    return m_pages.size();
+}
+
+uint32_t TextureAtlas::getRegionsCount()
+{
+    std::scoped_lock l(m_mutex);
+
+    uint32_t count = 0;
+    for (const auto& page : m_pages)
+        count += page.regions;
+    return count;
+}
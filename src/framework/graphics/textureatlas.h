@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "texture.h"
+
+// Packs many small images into a few large textures (pages), so draws that
+// would bind different textures can be merged into the same batch.
+// Regions are packed in shelves of equal height; add/remove are thread safe,
+// pixels are uploaded to the GPU when the page is used by the painter.
+class TextureAtlas
+{
+public:
+    TextureAtlas(int pageSize = 2048, int maxRegionSize = 512) : m_pageSize(pageSize), m_maxRegionSize(maxRegionSize) {}
+
+    // returns the page where the image was placed and its rect inside it,
+    // or nullptr when the image does not fit in a page.
+    TexturePtr add(const ImagePtr& image, Rect& rect);
+    void remove(const TexturePtr& page, const Rect& rect);
+    void clear();
+
+    uint32_t getPagesCount();
+    uint32_t getRegionsCount();
+
+private:
+    static constexpr int PADDING = 1;
+
+    struct Shelf
+    {
+        int y{ 0 };
+        int height{ 0 };
+        int nextX{ 0 };
+        std::vector<std::pair<int, int>> freeSlots; // x, width
+    };
+
+    struct Page
+    {
+        TexturePtr texture;
+        std::vector<Shelf> shelves;
+        int nextY{ 0 };
+        uint32_t regions{ 0 };
+    };
+
+    bool allocate(Page& page, const Size& size, Point& pos);
+
+    int m_pageSize;
+    int m_maxRegionSize;
+
+    std::vector<Page> m_pages;
+    std::mutex m_mutex;
+};
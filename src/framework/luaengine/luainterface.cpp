@@ -154,6 +154,8 @@ void LuaInterface::registerClassMemberField(const std::string_view className,
                                             const LuaCppFunction& getFunction,
                                             const LuaCppFunction& setFunction)
 {
+    resetFieldMethodsCache();
+
     getGlobal(className.data() + "_fieldmethods"s);
 
     if (getFunction) {
@@ -179,27 +181,32 @@ int LuaInterface::luaObjectGetEvent(LuaInterface* lua)
 {
     // stack: obj, key
     const auto& obj = lua->toObject(-2);
-    const auto& key = lua->toString(-1);
     assert(obj);
 
-    lua->remove(-1); // removes key
-
     // if a get method for this key exists, calls it
-    lua->getMetatable(); // pushes obj metatable
-    lua->getField("fieldmethods"); // push obj fieldmethods
-    lua->remove(-2); // removes obj metatable
-    lua->getField("get_" + key); // pushes get method
-    lua->remove(-2); // remove obj fieldmethods
-    if (!lua->isNil()) { // is the get method not nil?
+    lua->pushFieldMethod(-2, -1, false); // pushes get method
+    if (!lua->isBoolean()) { // is the get method not false?
+        lua->remove(-2); // removes key
         lua->insert(-2); // moves obj to the top
         lua->signalCall(1, 1); // calls get method, arguments: obj
         return 1;
     }
-    lua->pop(); // pops the nil get method
+    lua->pop(); // pops the false get method
 
     // if the field for this key exists, returns it
-    obj->luaGetField(key);
+    if (lua->isNumber()) {
+        obj->luaGetField(lua->toString());
+    } else {
+        // string keys are looked up directly, without converting them
+        obj->luaGetFieldsTable(); // pushes obj fields table
+        if (!lua->isNil()) {
+            lua->pushValue(-2); // pushes key
+            lua->rawGet(-2); // pushes the field value
+            lua->remove(-2); // removes obj fields table
+        }
+    }
     if (!lua->isNil()) {
+        lua->remove(-2); // removes key
         lua->remove(-2); // removes the obj
         // field value is on the stack
         return 1;
@@ -207,10 +214,11 @@ int LuaInterface::luaObjectGetEvent(LuaInterface* lua)
     lua->pop(); // pops the nil field
 
     // pushes the method assigned by this key
-    lua->getMetatable();  // pushes obj metatable
+    lua->getMetatable(-2); // pushes obj metatable
     lua->getField("methods"); // push obj methods
     lua->remove(-2); // removes obj metatable
-    lua->getField(key); // pushes obj method
+    lua->insert(-2); // moves key to the top
+    lua->getTable(); // pushes obj method
     lua->remove(-2); // remove obj methods
     lua->remove(-2); // removes obj
 
@@ -222,32 +230,89 @@ int LuaInterface::luaObjectSetEvent(LuaInterface* lua)
 {
     // stack: obj, key, value
     const auto& obj = lua->toObject(-3);
-    const auto& key = lua->toString(-2);
     assert(obj);
 
-    lua->remove(-2); // removes key
-    lua->insert(-2); // moves obj to the top
-
     // check if a set method for this field exists and call it
-    lua->getMetatable(); // pushes obj metatable
-    lua->getField("fieldmethods"); // push obj fieldmethods
-    lua->remove(-2); // removes obj metatable
-    lua->getField("set_" + key); // pushes set method
-    lua->remove(-2); // remove obj fieldmethods
-    if (!lua->isNil()) { // is the set method not nil?
-        lua->insert(-3); // moves func to -3
-        lua->insert(-2); // moves obj to -2, and value to -1
+    lua->pushFieldMethod(-3, -2, true); // pushes set method
+    if (!lua->isBoolean()) { // is the set method not false?
+        lua->insert(-4); // moves func to -4
+        lua->remove(-2); // removes key
         lua->signalCall(2, 0); // calls set method, arguments: obj, value
         return 0;
     }
-    lua->pop(); // pops the nil set method
+    lua->pop(); // pops the false set method
 
     // no set method exists, then treats as an field and set it
-    lua->pop(); // pops the object
+    const auto& key = lua->toString(-2);
+    lua->remove(-2); // removes key
+    lua->remove(-2); // removes the object
     obj->luaSetField(key); // sets the obj field
     return 0;
 }
 
+void LuaInterface::pushFieldMethod(int objIndex, int keyIndex, bool setter)
+{
+    const int top = getTop();
+    objIndex = objIndex < 0 ? top + objIndex + 1 : objIndex;
+    keyIndex = keyIndex < 0 ? top + keyIndex + 1 : keyIndex;
+
+    const auto& lookup = [&] {
+        getMetatable(objIndex); // pushes obj metatable
+        getField("fieldmethods"); // push obj fieldmethods
+        remove(-2); // removes obj metatable
+        getField((setter ? "set_" : "get_") + toString(keyIndex)); // pushes field method
+        remove(-2); // removes obj fieldmethods
+        if (isNil()) {
+            pop();
+            pushBoolean(false);
+        }
+    };
+
+    // numbers would be converted to strings by lua, so they are not cached
+    if (!isString(keyIndex) || isNumber(keyIndex)) {
+        lookup();
+        return;
+    }
+
+    getRef(setter ? m_setFieldCacheRef : m_getFieldCacheRef); // pushes cache
+    getMetatable(objIndex); // pushes obj metatable
+    pushValue();
+    rawGet(-3); // pushes class cache
+    if (isNil()) {
+        pop();
+        newTable();
+        pushValue(-2); // pushes obj metatable
+        pushValue(-2); // pushes class cache
+        rawSet(-5); // cache[metatable] = class cache
+    }
+
+    pushValue(keyIndex);
+    rawGet(-2); // pushes cached field method
+    if (isNil()) {
+        pop();
+        lookup();
+        pushValue(keyIndex);
+        pushValue(-2);
+        rawSet(-4); // class cache[key] = field method or false
+    }
+
+    insert(top + 1); // moves field method below the cache
+    pop(3); // pops cache, obj metatable and class cache
+}
+
+void LuaInterface::resetFieldMethodsCache()
+{
+    if (m_getFieldCacheRef)
+        unref(m_getFieldCacheRef);
+    if (m_setFieldCacheRef)
+        unref(m_setFieldCacheRef);
+
+    newTable();
+    m_getFieldCacheRef = ref();
+    newTable();
+    m_setFieldCacheRef = ref();
+}
+
 int LuaInterface::luaObjectEqualEvent(LuaInterface* lua)
 {
     // stack: obj1, obj2
@@ -748,6 +813,8 @@ void LuaInterface::createLuaState()
     setMetatable();
     m_weakTableRef = ref();
 
+    resetFieldMethodsCache();
+
     // installs script loader
     getGlobal("package");
     getField("loaders");
@@ -774,6 +841,8 @@ void LuaInterface::closeLuaState()
         // close lua, it also collects
         lua_close(L);
         L = nullptr;
+        m_getFieldCacheRef = 0;
+        m_setFieldCacheRef = 0;
     }
 }
 
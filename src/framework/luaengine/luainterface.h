@@ -155,6 +155,12 @@ private:
     /// existence by lua until it got no references left
     static int luaObjectCollectEvent(LuaInterface* lua);
 
+    /// Pushes the get_/set_ field method of the object class for the key, or false if there is none.
+    /// Results are cached by class metatable and key, as lua strings are interned a cache hit
+    /// costs two raw table lookups and no string is built
+    void pushFieldMethod(int objIndex, int keyIndex, bool setter);
+    void resetFieldMethodsCache();
+
 public:
     /// Loads and runs a script, any errors are printed to stdout and returns false
     bool safeRunScript(const std::string& fileName);
@@ -375,6 +381,8 @@ public:
 private:
     lua_State* L{ nullptr };
     int m_weakTableRef{ 0 };
+    int m_getFieldCacheRef{ 0 };
+    int m_setFieldCacheRef{ 0 };
     int m_cppCallbackDepth{ 0 };
     int m_totalObjRefs{ 0 };
     int m_totalFuncRefs{ 0 };
@@ -319,6 +319,7 @@ void Application::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_app", "getTargetFps", &GraphicalApplication::getTargetFps, &g_app);
     g_lua.bindSingletonFunction("g_app", "setTargetFps", &GraphicalApplication::setTargetFps, &g_app);
     g_lua.bindSingletonFunction("g_app", "resetTargetFps", &GraphicalApplication::resetTargetFps, &g_app);
+    g_lua.bindSingletonFunction("g_app", "getDrawCalls", &GraphicalApplication::getDrawCalls, &g_app);
 
     g_lua.bindSingletonFunction("g_app", "isDrawingTexts", &GraphicalApplication::isDrawingTexts, &g_app);
     g_lua.bindSingletonFunction("g_app", "setDrawTexts", &GraphicalApplication::setDrawTexts, &g_app);
@@ -417,6 +418,8 @@ void Application::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_fonts", "clearFonts", &FontManager::clearFonts, &g_fonts);
     g_lua.bindSingletonFunction("g_fonts", "importFont", &FontManager::importFont, &g_fonts);
     g_lua.bindSingletonFunction("g_fonts", "fontExists", &FontManager::fontExists, &g_fonts);
+    g_lua.bindSingletonFunction("g_fonts", "getLayoutCacheHits", &FontManager::getLayoutCacheHits, &g_fonts);
+    g_lua.bindSingletonFunction("g_fonts", "getLayoutCacheMisses", &FontManager::getLayoutCacheMisses, &g_fonts);
 
     // ParticleManager
     g_lua.registerSingletonClass("g_particles");
@@ -186,6 +186,26 @@ void Connection::read(uint16_t bytes, const RecvCallback& callback)
     });
 }
 
+void Connection::read(const InputMessagePtr& message, uint8_t* buffer, uint16_t bytes, const RecvCallback& callback)
+{
+    if (!m_connected)
+        return;
+
+    m_recvCallback = callback;
+
+    async_read(m_socket,
+               asio::buffer(buffer, bytes),
+               [capture0 = asConnection(), message, buffer](auto&& PH1, auto&& PH2) {
+        capture0->onRecv(std::forward<decltype(PH1)>(PH1), std::forward<decltype(PH2)>(PH2), buffer);
+    });
+
+    m_readTimer.cancel();
+    m_readTimer.expires_from_now(asio::chrono::seconds(static_cast<uint32_t>(READ_TIMEOUT)));
+    m_readTimer.async_wait([capture0 = asConnection()](auto&& PH1) {
+        capture0->onTimeout(std::forward<decltype(PH1)>(PH1));
+    });
+}
+
 void Connection::read_until(const std::string_view what, const RecvCallback& callback)
 {
     if (!m_connected)
@@ -290,7 +310,7 @@ void Connection::onWrite(const std::error_code& error, size_t, const std::shared
         handleError(error);
 }
 
-void Connection::onRecv(const std::error_code& error, size_t recvSize)
+void Connection::onRecv(const std::error_code& error, size_t recvSize, uint8_t* buffer)
 {
     m_readTimer.cancel();
     m_activityTimer.restart();
@@ -301,14 +321,15 @@ void Connection::onRecv(const std::error_code& error, size_t recvSize)
     if (m_connected) {
         if (!error) {
             if (m_recvCallback) {
-                const auto* header = asio::buffer_cast<const char*>(m_inputStream.data());
-                m_recvCallback((uint8_t*)header, recvSize);
+                auto* data = buffer ? buffer : (uint8_t*)asio::buffer_cast<const char*>(m_inputStream.data());
+                m_recvCallback(data, recvSize);
             }
         } else
             handleError(error);
     }
 
-    if (!error)
+    // data read straight into the caller buffer never went through the stream
+    if (!error && !buffer)
         m_inputStream.consume(recvSize);
 }
 
@@ -52,6 +52,8 @@ public:
 
     void write(uint8_t* buffer, size_t size);
     void read(uint16_t bytes, const RecvCallback& callback);
+    // reads straight into buffer, a write buffer of message, which is kept alive until the read completes
+    void read(const InputMessagePtr& message, uint8_t* buffer, uint16_t bytes, const RecvCallback& callback);
     void read_until(const std::string_view what, const RecvCallback& callback);
     void read_some(const RecvCallback& callback);
 
@@ -73,7 +75,7 @@ protected:
     void onCanWrite(const std::error_code& error);
     void onWrite(const std::error_code& error, size_t writeSize, const std::shared_ptr<asio::streambuf>&
                  outputStream);
-    void onRecv(const std::error_code& error, size_t recvSize);
+    void onRecv(const std::error_code& error, size_t recvSize, uint8_t* buffer = nullptr);
     void onTimeout(const std::error_code& error);
     void handleError(const std::error_code& error);
 
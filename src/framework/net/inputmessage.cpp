@@ -110,6 +110,14 @@ void InputMessage::fillBuffer(uint8_t* buffer, uint16_t size)
     m_messageSize += size;
 }
 
+void InputMessage::copyHeader(const InputMessage& other)
+{
+    m_headerPos = other.m_headerPos;
+    m_readPos = other.m_readPos;
+    m_messageSize = other.m_readPos - other.m_headerPos;
+    memcpy(m_buffer + m_headerPos, other.m_buffer + other.m_headerPos, m_messageSize);
+}
+
 void InputMessage::setHeaderSize(uint16_t size)
 {
     assert(MAX_HEADER_SIZE - size >= 0);
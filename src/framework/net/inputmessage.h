@@ -78,6 +78,15 @@ protected:
     void reset();
     void fillBuffer(uint8_t* buffer, uint16_t size);
 
+    // room for the next bytes of the message, so they can be received in place
+    uint8_t* getWriteBuffer(uint16_t size)
+    {
+        checkWrite(m_headerPos + m_messageSize + size);
+        return m_buffer + m_headerPos + m_messageSize;
+    }
+    void addMessageSize(uint16_t size) { m_messageSize += size; }
+    void copyHeader(const InputMessage& other);
+
     void setHeaderSize(uint16_t size);
     void setMessageSize(uint16_t size) { m_messageSize = size; }
 
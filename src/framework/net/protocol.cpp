@@ -25,7 +25,15 @@
 #include <framework/core/application.h>
 #include "connection.h"
 
-Protocol::Protocol() :m_inputMessage(std::make_shared<InputMessage>()) {
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define XTEA_SSE2
+#elif defined(__ARM_NEON) && (!defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#include <arm_neon.h>
+#define XTEA_NEON
+#endif
+
+Protocol::Protocol() :m_inputMessage(std::make_shared<InputMessage>()), m_inflateMessage(std::make_shared<InputMessage>()) {
     inflateInit2(&m_zstream, -15);
 }
 
@@ -88,9 +96,9 @@ void Protocol::recv()
         headerSize += 2; // 2 bytes for XTEA encrypted message size
     m_inputMessage->setHeaderSize(headerSize);
 
-    // read the first 2 bytes which contain the message size
+    // read the first 2 bytes which contain the message size, straight into the message
     if (m_connection)
-        m_connection->read(2, [capture0 = asProtocol()](auto&& PH1, auto&& PH2) {
+        m_connection->read(m_inputMessage, m_inputMessage->getWriteBuffer(2), 2, [capture0 = asProtocol()](auto&& PH1, auto&& PH2) {
         capture0->internalRecvHeader(std::forward<decltype(PH1)>(PH1),
         std::forward<decltype(PH2)>(PH2));
     });
@@ -99,12 +107,12 @@ void Protocol::recv()
 void Protocol::internalRecvHeader(uint8_t* buffer, uint16_t size)
 {
     // read message size
-    m_inputMessage->fillBuffer(buffer, size);
+    m_inputMessage->addMessageSize(size);
     const uint16_t remainingSize = m_inputMessage->readSize();
 
     // read remaining message data
     if (m_connection)
-        m_connection->read(remainingSize, [capture0 = asProtocol()](auto&& PH1, auto&& PH2) {
+        m_connection->read(m_inputMessage, m_inputMessage->getWriteBuffer(remainingSize), remainingSize, [capture0 = asProtocol()](auto&& PH1, auto&& PH2) {
         capture0->internalRecvData(std::forward<decltype(PH1)>(PH1),
         std::forward<decltype(PH2)>(PH2));
     });
@@ -118,7 +126,7 @@ void Protocol::internalRecvData(uint8_t* buffer, uint16_t size)
         return;
     }
 
-    m_inputMessage->fillBuffer(buffer, size);
+    m_inputMessage->addMessageSize(size);
 
     bool decompress = false;
     if (m_sequencedPackets) {
@@ -136,12 +144,14 @@ void Protocol::internalRecvData(uint8_t* buffer, uint16_t size)
     }
 
     if (decompress) {
-        static uint8_t zbuffer[InputMessage::BUFFER_MAXSIZE];
+        // inflate right after the header of the spare message, then use it as the current one
+        m_inflateMessage->reset();
+        m_inflateMessage->copyHeader(*m_inputMessage);
 
         m_zstream.next_in = m_inputMessage->getDataBuffer();
-        m_zstream.next_out = zbuffer;
+        m_zstream.next_out = m_inflateMessage->getReadBuffer();
         m_zstream.avail_in = m_inputMessage->getUnreadSize();
-        m_zstream.avail_out = InputMessage::BUFFER_MAXSIZE;
+        m_zstream.avail_out = InputMessage::BUFFER_MAXSIZE - m_inflateMessage->getReadPos();
 
         int32_t ret = inflate(&m_zstream, Z_FINISH);
         if (ret != Z_OK && ret != Z_STREAM_END) {
@@ -156,8 +166,8 @@ void Protocol::internalRecvData(uint8_t* buffer, uint16_t size)
             return;
         }
 
-        m_inputMessage->fillBuffer(zbuffer, totalSize);
-        m_inputMessage->setMessageSize(m_inputMessage->getHeaderSize() + totalSize);
+        m_inflateMessage->setMessageSize(m_inflateMessage->getHeaderSize() + totalSize);
+        std::swap(m_inputMessage, m_inflateMessage);
     }
 
     onRecv(m_inputMessage);
@@ -173,15 +183,54 @@ void Protocol::generateXteaKey()
 namespace
 {
     constexpr uint32_t delta = 0x9E3779B9;
+    constexpr uint8_t rounds = 32;
+
+    // key added on each half round, the same for every block
+    struct XteaSchedule
+    {
+        uint32_t first[rounds];
+        uint32_t second[rounds];
+    };
+
+    XteaSchedule makeEncryptSchedule(const std::array<uint32_t, 4>& key)
+    {
+        XteaSchedule schedule;
+        for (uint32_t i = 0, sum = 0, next_sum = sum + delta; i < rounds; ++i, sum = next_sum, next_sum += delta) {
+            schedule.first[i] = sum + key[sum & 3];
+            schedule.second[i] = next_sum + key[(next_sum >> 11) & 3];
+        }
+        return schedule;
+    }
 
-    template<typename Round>
-    void apply_rounds(uint8_t* data, size_t length, Round round)
+    XteaSchedule makeDecryptSchedule(const std::array<uint32_t, 4>& key)
     {
-        for (auto j = 0u; j < length; j += 8) {
+        XteaSchedule schedule;
+        for (uint32_t i = 0, sum = delta * rounds, next_sum = sum - delta; i < rounds; ++i, sum = next_sum, next_sum -= delta) {
+            schedule.first[i] = sum + key[(sum >> 11) & 3];
+            schedule.second[i] = next_sum + key[next_sum & 3];
+        }
+        return schedule;
+    }
+
+    inline uint32_t mix(uint32_t v) { return (v << 4 ^ v >> 5) + v; }
+
+    // blocks are little endian pairs of 32 bits words
+    template<bool Encrypt>
+    void apply_rounds(uint8_t* data, size_t length, const XteaSchedule& schedule)
+    {
+        for (size_t j = 0; j < length; j += 8) {
             uint32_t left = data[j + 0] | data[j + 1] << 8u | data[j + 2] << 16u | data[j + 3] << 24u,
                 right = data[j + 4] | data[j + 5] << 8u | data[j + 6] << 16u | data[j + 7] << 24u;
 
-            round(left, right);
+            for (uint8_t i = 0; i < rounds; ++i) {
+                if constexpr (Encrypt) {
+                    left += mix(right) ^ schedule.first[i];
+                    right += mix(left) ^ schedule.second[i];
+                } else {
+                    right -= mix(left) ^ schedule.first[i];
+                    left -= mix(right) ^ schedule.second[i];
+                }
+            }
 
             data[j] = static_cast<uint8_t>(left);
             data[j + 1] = static_cast<uint8_t>(left >> 8u);
@@ -193,6 +242,103 @@ namespace
             data[j + 7] = static_cast<uint8_t>(right >> 24u);
         }
     }
+
+#if defined(XTEA_SSE2)
+    inline __m128i mix(__m128i v) { return _mm_add_epi32(_mm_xor_si128(_mm_slli_epi32(v, 4), _mm_srli_epi32(v, 5)), v); }
+
+    // 8 blocks per iteration, as two independent groups of 4 to hide latency
+    template<bool Encrypt>
+    size_t apply_rounds_simd(uint8_t* data, size_t length, const XteaSchedule& schedule)
+    {
+        size_t j = 0;
+        for (; j + 64 <= length; j += 64) {
+            auto* blocks = reinterpret_cast<__m128i*>(data + j);
+
+            // [L0 R0 L1 R1] [L2 R2 L3 R3] -> [L0 L1 L2 L3] [R0 R1 R2 R3]
+            __m128i a0 = _mm_shuffle_epi32(_mm_loadu_si128(blocks + 0), _MM_SHUFFLE(3, 1, 2, 0));
+            __m128i b0 = _mm_shuffle_epi32(_mm_loadu_si128(blocks + 1), _MM_SHUFFLE(3, 1, 2, 0));
+            __m128i a1 = _mm_shuffle_epi32(_mm_loadu_si128(blocks + 2), _MM_SHUFFLE(3, 1, 2, 0));
+            __m128i b1 = _mm_shuffle_epi32(_mm_loadu_si128(blocks + 3), _MM_SHUFFLE(3, 1, 2, 0));
+
+            __m128i left0 = _mm_unpacklo_epi64(a0, b0), right0 = _mm_unpackhi_epi64(a0, b0);
+            __m128i left1 = _mm_unpacklo_epi64(a1, b1), right1 = _mm_unpackhi_epi64(a1, b1);
+
+            for (uint8_t i = 0; i < rounds; ++i) {
+                const __m128i first = _mm_set1_epi32(static_cast<int>(schedule.first[i]));
+                const __m128i second = _mm_set1_epi32(static_cast<int>(schedule.second[i]));
+                if constexpr (Encrypt) {
+                    left0 = _mm_add_epi32(left0, _mm_xor_si128(mix(right0), first));
+                    left1 = _mm_add_epi32(left1, _mm_xor_si128(mix(right1), first));
+                    right0 = _mm_add_epi32(right0, _mm_xor_si128(mix(left0), second));
+                    right1 = _mm_add_epi32(right1, _mm_xor_si128(mix(left1), second));
+                } else {
+                    right0 = _mm_sub_epi32(right0, _mm_xor_si128(mix(left0), first));
+                    right1 = _mm_sub_epi32(right1, _mm_xor_si128(mix(left1), first));
+                    left0 = _mm_sub_epi32(left0, _mm_xor_si128(mix(right0), second));
+                    left1 = _mm_sub_epi32(left1, _mm_xor_si128(mix(right1), second));
+                }
+            }
+
+            a0 = _mm_unpacklo_epi64(left0, right0), b0 = _mm_unpackhi_epi64(left0, right0);
+            a1 = _mm_unpacklo_epi64(left1, right1), b1 = _mm_unpackhi_epi64(left1, right1);
+
+            _mm_storeu_si128(blocks + 0, _mm_shuffle_epi32(a0, _MM_SHUFFLE(3, 1, 2, 0)));
+            _mm_storeu_si128(blocks + 1, _mm_shuffle_epi32(b0, _MM_SHUFFLE(3, 1, 2, 0)));
+            _mm_storeu_si128(blocks + 2, _mm_shuffle_epi32(a1, _MM_SHUFFLE(3, 1, 2, 0)));
+            _mm_storeu_si128(blocks + 3, _mm_shuffle_epi32(b1, _MM_SHUFFLE(3, 1, 2, 0)));
+        }
+        return j;
+    }
+#elif defined(XTEA_NEON)
+    inline uint32x4_t mix(uint32x4_t v) { return vaddq_u32(veorq_u32(vshlq_n_u32(v, 4), vshrq_n_u32(v, 5)), v); }
+
+    // 8 blocks per iteration, as two independent groups of 4 to hide latency
+    template<bool Encrypt>
+    size_t apply_rounds_simd(uint8_t* data, size_t length, const XteaSchedule& schedule)
+    {
+        size_t j = 0;
+        for (; j + 64 <= length; j += 64) {
+            auto* words = reinterpret_cast<uint32_t*>(data + j);
+
+            // vld2 splits the blocks into lefts and rights
+            uint32x4x2_t group0 = vld2q_u32(words);
+            uint32x4x2_t group1 = vld2q_u32(words + 8);
+
+            for (uint8_t i = 0; i < rounds; ++i) {
+                const uint32x4_t first = vdupq_n_u32(schedule.first[i]);
+                const uint32x4_t second = vdupq_n_u32(schedule.second[i]);
+                if constexpr (Encrypt) {
+                    group0.val[0] = vaddq_u32(group0.val[0], veorq_u32(mix(group0.val[1]), first));
+                    group1.val[0] = vaddq_u32(group1.val[0], veorq_u32(mix(group1.val[1]), first));
+                    group0.val[1] = vaddq_u32(group0.val[1], veorq_u32(mix(group0.val[0]), second));
+                    group1.val[1] = vaddq_u32(group1.val[1], veorq_u32(mix(group1.val[0]), second));
+                } else {
+                    group0.val[1] = vsubq_u32(group0.val[1], veorq_u32(mix(group0.val[0]), first));
+                    group1.val[1] = vsubq_u32(group1.val[1], veorq_u32(mix(group1.val[0]), first));
+                    group0.val[0] = vsubq_u32(group0.val[0], veorq_u32(mix(group0.val[1]), second));
+                    group1.val[0] = vsubq_u32(group1.val[0], veorq_u32(mix(group1.val[1]), second));
+                }
+            }
+
+            vst2q_u32(words, group0);
+            vst2q_u32(words + 8, group1);
+        }
+        return j;
+    }
+#else
+    template<bool Encrypt>
+    size_t apply_rounds_simd(uint8_t*, size_t, const XteaSchedule&) { return 0; }
+#endif
+
+    template<bool Encrypt>
+    void xtea(uint8_t* data, size_t length, const std::array<uint32_t, 4>& key)
+    {
+        const auto& schedule = Encrypt ? makeEncryptSchedule(key) : makeDecryptSchedule(key);
+
+        // the blocks left over by the vector path go through the scalar one
+        const size_t processed = apply_rounds_simd<Encrypt>(data, length, schedule);
+        apply_rounds<Encrypt>(data + processed, length - processed, schedule);
+    }
 }
 
 bool Protocol::xteaDecrypt(const InputMessagePtr& inputMessage) const
@@ -203,12 +349,7 @@ bool Protocol::xteaDecrypt(const InputMessagePtr& inputMessage) const
         return false;
     }
 
-    for (uint32_t i = 0, sum = delta << 5, next_sum = sum - delta; i < 32; ++i, sum = next_sum, next_sum -= delta) {
-        apply_rounds(inputMessage->getReadBuffer(), encryptedSize, [&](uint32_t& left, uint32_t& right) {
-            right -= ((left << 4 ^ left >> 5) + left) ^ (sum + m_xteaKey[(sum >> 11) & 3]);
-            left -= ((right << 4 ^ right >> 5) + right) ^ (next_sum + m_xteaKey[next_sum & 3]);
-        });
-    }
+    xtea<false>(inputMessage->getReadBuffer(), encryptedSize, m_xteaKey);
 
     const uint16_t decryptedSize = inputMessage->getU16() + 2;
     const int sizeDelta = decryptedSize - encryptedSize;
@@ -233,12 +374,7 @@ void Protocol::xteaEncrypt(const OutputMessagePtr& outputMessage) const
         encryptedSize += n;
     }
 
-    for (uint32_t i = 0, sum = 0, next_sum = sum + delta; i < 32; ++i, sum = next_sum, next_sum += delta) {
-        apply_rounds(outputMessage->getDataBuffer() - 2, encryptedSize, [&](uint32_t& left, uint32_t& right) {
-            left += ((right << 4 ^ right >> 5) + right) ^ (sum + m_xteaKey[sum & 3]);
-            right += ((left << 4 ^ left >> 5) + left) ^ (next_sum + m_xteaKey[(next_sum >> 11) & 3]);
-        });
-    }
+    xtea<true>(outputMessage->getDataBuffer() - 2, encryptedSize, m_xteaKey);
 }
 
 void Protocol::onConnect() { callLuaField("onConnect"); }
@@ -81,6 +81,7 @@ private:
 
     ConnectionPtr m_connection;
     InputMessagePtr m_inputMessage;
+    InputMessagePtr m_inflateMessage; // swapped with m_inputMessage when a message is inflated
 
     z_stream m_zstream{};
 };
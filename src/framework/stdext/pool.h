@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace stdext
+{
+    // Fixed size blocks carved from large slabs, released blocks are kept
+    // in a free list and handed out again instead of going back to the heap.
+    template<size_t Size, size_t Align>
+    class object_pool
+    {
+    public:
+        // never destroyed, objects may still be released during static destruction
+        static object_pool& get()
+        {
+            static auto* pool = new object_pool;
+            return *pool;
+        }
+
+        void* allocate()
+        {
+            std::scoped_lock l(m_mutex);
+            if (!m_free)
+                grow();
+
+            Block* block = m_free;
+            m_free = block->next;
+            return block;
+        }
+
+        void deallocate(void* ptr)
+        {
+            std::scoped_lock l(m_mutex);
+            auto* block = static_cast<Block*>(ptr);
+            block->next = m_free;
+            m_free = block;
+        }
+
+    private:
+        static constexpr size_t BLOCKS_PER_SLAB = 256;
+
+        union Block
+        {
+            Block* next;
+            alignas(Align) std::byte storage[Size];
+        };
+
+        void grow()
+        {
+            auto& slab = m_slabs.emplace_back(std::make_unique<Block[]>(BLOCKS_PER_SLAB));
+            for (size_t i = 0; i < BLOCKS_PER_SLAB; ++i) {
+                slab[i].next = m_free;
+                m_free = &slab[i];
+            }
+        }
+
+        std::vector<std::unique_ptr<Block[]>> m_slabs;
+        Block* m_free{ nullptr };
+        std::mutex m_mutex;
+    };
+
+    // Allocator for std::allocate_shared, the object and its control block
+    // come from the pool matching their combined size.
+    template<class T>
+    struct pool_allocator
+    {
+        using value_type = T;
+
+        pool_allocator() noexcept = default;
+        template<class U>
+        pool_allocator(const pool_allocator<U>&) noexcept {}
+
+        T* allocate(size_t n)
+        {
+            if (n != 1)
+                return static_cast<T*>(::operator new(n * sizeof(T)));
+            return static_cast<T*>(object_pool<sizeof(T), alignof(T)>::get().allocate());
+        }
+
+        void deallocate(T* ptr, size_t n) noexcept
+        {
+            if (n != 1)
+                ::operator delete(ptr);
+            else
+                object_pool<sizeof(T), alignof(T)>::get().deallocate(ptr);
+        }
+
+        template<class U>
+        bool operator==(const pool_allocator<U>&) const noexcept { return true; }
+        template<class U>
+        bool operator!=(const pool_allocator<U>&) const noexcept { return false; }
+    };
+
+    template<class T, class... Args>
+    std::shared_ptr<T> make_pooled(Args&&... args)
+    {
+        return std::allocate_shared<T>(pool_allocator<T>(), std::forward<Args>(args)...);
+    }
+}
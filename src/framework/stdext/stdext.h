@@ -36,6 +36,7 @@
 #include "format.h"
 #include "hash.h"
 #include "math.h"
+#include "pool.h"
 #include "storage.h"
 #include "string.h"
 #include "time.h"